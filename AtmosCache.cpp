@@ -0,0 +1,247 @@
+#include "AtmosCache.h"
+#include "MappedFile.h"
+#include <fstream>
+#include <string>
+#include <cstring>
+#include <cstdio>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#endif
+
+//----------------------------------------------------------------------------------
+
+bool LoadAtmosCache(const std::string & cachePath, const Vector<std::string> & filenames,
+                    AtmosLogType & atmosData, LoadStatus * fileStatus)
+{
+    MappedFile cache;
+    if (!cache.Open(cachePath) || cache.GetSize() < sizeof(AtmosCacheHeader))
+    {
+        return false;
+    }
+
+    AtmosCacheHeader header;
+    std::memcpy(&header, cache.GetData(), sizeof(header));
+    if (std::memcmp(header.magic, "ATMC", 4) != 0 || header.version != ATMOS_CACHE_VERSION ||
+        header.fileCount != static_cast<std::uint32_t>(filenames.GetSize()) ||
+        header.payloadSize != cache.GetSize() - sizeof(header))
+    {
+        return false;
+    }
+
+    const char * payload = cache.GetData() + sizeof(header);
+    const char * payloadEnd = payload + header.payloadSize;
+    if (ComputeChecksum(payload, header.payloadSize) != header.checksum)
+    {
+        return false;
+    }
+
+    // The manifest must describe exactly the files that are listed now, unchanged since they were cached
+    const char * p = payload;
+    for (int i = 0; i < filenames.GetSize(); i++)
+    {
+        AtmosCacheEntry entry;
+        if (payloadEnd - p < static_cast<long long>(sizeof(entry)))
+        {
+            return false;
+        }
+        std::memcpy(&entry, p, sizeof(entry));
+        p += sizeof(entry);
+
+        std::size_t paddedLength = (entry.nameLength + 7) & ~static_cast<std::size_t>(7);
+        if (static_cast<std::size_t>(payloadEnd - p) < paddedLength ||
+            filenames[i].compare(0, std::string::npos, p, entry.nameLength) != 0)
+        {
+            return false;
+        }
+        p += paddedLength;
+
+        FileStampType stamp;
+        GetFileStamp("data/" + filenames[i], stamp);
+        if (stamp.size != entry.size || stamp.mtime != entry.mtime)
+        {
+            return false;
+        }
+    }
+
+    std::size_t n = header.recordCount;
+    std::size_t columnBytes = n * (3 * sizeof(float) + sizeof(std::uint32_t) + sizeof(std::uint16_t));
+    if (static_cast<std::size_t>(payloadEnd - p) != columnBytes)
+    {
+        return false;
+    }
+
+    // Columns start on an 8-byte boundary of a page-aligned mapping, so they can be read in place
+    const float * speed = reinterpret_cast<const float *>(p);
+    const float * temperature = speed + n;
+    const float * solar = temperature + n;
+    const std::uint32_t * dateKeys = reinterpret_cast<const std::uint32_t *>(solar + n);
+    const std::uint16_t * timeKeys = reinterpret_cast<const std::uint16_t *>(dateKeys + n);
+
+    atmosData.Reserve(atmosData.GetSize() + static_cast<int>(n));
+    for (std::size_t i = 0; i < n; i++)
+    {
+        AtmosRecType a;
+        a.date = Date(dateKeys[i] & 0x1F, (dateKeys[i] >> 5) & 0xF, dateKeys[i] >> 9);
+        a.time = MyTime(timeKeys[i] >> 6, timeKeys[i] & 0x3F);
+        a.timestamp = MakeTimestamp(a.date, a.time);
+        a.speed = speed[i];
+        a.temperature = temperature[i];
+        a.solar_rad = solar[i];
+        atmosData.PushBack(a);
+    }
+
+    // Re-read the statuses so that the same warnings can be reported as on a cold load
+    p = payload;
+    for (int i = 0; i < filenames.GetSize(); i++)
+    {
+        AtmosCacheEntry entry;
+        std::memcpy(&entry, p, sizeof(entry));
+        fileStatus[i] = static_cast<LoadStatus>(entry.status);
+        p += sizeof(entry) + ((entry.nameLength + 7) & ~static_cast<std::size_t>(7));
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+
+bool SaveAtmosCache(const std::string & cachePath, const Vector<std::string> & filenames,
+                    const FileStampType * fileStamps, const LoadStatus * fileStatus, const AtmosLogType & atmosData)
+{
+    // Build the payload in memory so that its checksum can go into the header
+    std::string payload;
+    for (int i = 0; i < filenames.GetSize(); i++)
+    {
+        AtmosCacheEntry entry;
+        entry.nameLength = filenames[i].size();
+        entry.status = fileStatus[i];
+        entry.size = fileStamps[i].size;
+        entry.mtime = fileStamps[i].mtime;
+
+        payload.append(reinterpret_cast<const char *>(&entry), sizeof(entry));
+        payload.append(filenames[i]);
+        payload.append(((entry.nameLength + 7) & ~7u) - entry.nameLength, '\0');
+    }
+
+    int n = atmosData.GetSize();
+    std::size_t columnsStart = payload.size();
+    payload.resize(columnsStart + n * (3 * sizeof(float) + sizeof(std::uint32_t) + sizeof(std::uint16_t)));
+
+    float * speed = reinterpret_cast<float *>(&payload[columnsStart]);
+    float * temperature = speed + n;
+    float * solar = temperature + n;
+    std::uint32_t * dateKeys = reinterpret_cast<std::uint32_t *>(solar + n);
+    std::uint16_t * timeKeys = reinterpret_cast<std::uint16_t *>(dateKeys + n);
+
+    for (int i = 0; i < n; i++)
+    {
+        speed[i] = atmosData[i].speed;
+        temperature[i] = atmosData[i].temperature;
+        solar[i] = atmosData[i].solar_rad;
+        dateKeys[i] = PackDateKey(atmosData[i].date);
+        timeKeys[i] = PackTimeKey(atmosData[i].time);
+    }
+
+    AtmosCacheHeader header;
+    std::memcpy(header.magic, "ATMC", 4);
+    header.version = ATMOS_CACHE_VERSION;
+    header.fileCount = filenames.GetSize();
+    header.recordCount = n;
+    header.payloadSize = payload.size();
+    header.checksum = ComputeChecksum(payload.data(), payload.size());
+
+    std::string tempPath = cachePath + ".tmp";
+    std::ofstream out(tempPath.c_str(), std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        return false;
+    }
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(payload.data(), payload.size());
+    out.close();
+    if (!out)
+    {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+    // rename() does not replace an existing file on Windows
+    std::remove(cachePath.c_str());
+    return std::rename(tempPath.c_str(), cachePath.c_str()) == 0;
+}
+
+//----------------------------------------------------------------------------------
+
+void GetFileStamp(const std::string & path, FileStampType & stamp)
+{
+#ifdef _WIN32
+    // _stat64 only has whole seconds, the last write time has 100 ns steps
+    WIN32_FILE_ATTRIBUTE_DATA info;
+    if (!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &info))
+    {
+        stamp.size = -1;
+        stamp.mtime = -1;
+        return;
+    }
+
+    stamp.size = (static_cast<std::int64_t>(info.nFileSizeHigh) << 32) | info.nFileSizeLow;
+    std::int64_t ticks = (static_cast<std::int64_t>(info.ftLastWriteTime.dwHighDateTime) << 32) |
+                         info.ftLastWriteTime.dwLowDateTime;
+    stamp.mtime = ticks * 100;
+#else
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0)
+    {
+        stamp.size = -1;
+        stamp.mtime = -1;
+        return;
+    }
+
+    stamp.size = info.st_size;
+#ifdef __APPLE__
+    stamp.mtime = static_cast<std::int64_t>(info.st_mtimespec.tv_sec) * 1000000000 + info.st_mtimespec.tv_nsec;
+#else
+    stamp.mtime = static_cast<std::int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+#endif
+#endif
+}
+
+//----------------------------------------------------------------------------------
+
+std::uint64_t ComputeChecksum(const char * data, std::size_t size)
+{
+    const std::uint64_t prime = 1099511628211ULL;
+    std::uint64_t hash = 14695981039346656037ULL;
+
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        std::uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        hash = (hash ^ word) * prime;
+    }
+    for (; i < size; i++)
+    {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * prime;
+    }
+
+    return hash;
+}
+
+//----------------------------------------------------------------------------------
+
+std::uint32_t PackDateKey(const Date & d)
+{
+    return (static_cast<std::uint32_t>(d.GetYear()) << 9) | (d.GetMonth() << 5) | d.GetDay();
+}
+
+//----------------------------------------------------------------------------------
+
+std::uint16_t PackTimeKey(const MyTime & t)
+{
+    return static_cast<std::uint16_t>((t.GetHour() << 6) | t.GetMinute());
+}
+
+//----------------------------------------------------------------------------------
@@ -0,0 +1,138 @@
+#ifndef ATMOSCACHE_H
+#define ATMOSCACHE_H
+
+//----------------------------------------------------------------------------------
+
+#include "AtmosphereLogTypes.h"
+#include "FileIO.h"
+#include "Vector.h"
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+//----------------------------------------------------------------------------------
+
+/// The version written to, and required in, the header of an atmosphere cache file.
+const std::uint32_t ATMOS_CACHE_VERSION = 2;
+
+//----------------------------------------------------------------------------------
+
+/// The fixed-size header at the start of an atmosphere cache file.
+///
+/// The header is followed by the payload: one manifest entry per file listed in data_source.txt, then the
+/// record columns speed[n], temperature[n], solar_rad[n] (float), date keys[n] (uint32) and time keys[n]
+/// (uint16). All values use the byte order of the machine that wrote the cache.
+typedef struct {
+    char magic[4]; /// Always "ATMC".
+    std::uint32_t version; /// Format version, must equal ATMOS_CACHE_VERSION.
+    std::uint32_t fileCount; /// Number of manifest entries in the payload.
+    std::uint32_t recordCount; /// Number of values in each column.
+    std::uint64_t payloadSize; /// Number of bytes that follow the header.
+    std::uint64_t checksum; /// ComputeChecksum() of the payload.
+} AtmosCacheHeader;
+
+/// The fixed-size part of a manifest entry, followed by the file name padded to a multiple of 8 bytes.
+typedef struct {
+    std::uint32_t nameLength; /// Length of the file name in bytes.
+    std::uint32_t status; /// The LoadStatus the file produced when the cache was written.
+    std::int64_t size; /// Size of the source file in bytes, or -1 if it did not exist.
+    std::int64_t mtime; /// Last modification time of the source file in nanoseconds, or -1 if it did not exist.
+} AtmosCacheEntry;
+
+/// The size and modification time of a source file, taken by GetFileStamp() before the file is parsed.
+typedef struct {
+    std::int64_t size; /// Size of the file in bytes, or -1 if it did not exist.
+    std::int64_t mtime; /// Last modification time in nanoseconds (100 ns steps on Windows), or -1 if it did not exist.
+} FileStampType;
+
+//----------------------------------------------------------------------------------
+
+    /**
+    * @brief Loads records from a cache file if it is still valid for the listed source files.
+    *
+    * Maps the cache file and checks its magic number, version, size and checksum. The manifest must list the same
+    * files in the same order, and each file must still have the recorded size and modification time (files that
+    * were missing must still be missing). Only then are the columns turned back into records.
+    *
+    * @param cachePath - Path of the cache file.
+    * @param filenames - The file names listed in data_source.txt, in order.
+    * @param atmosData - A reference to a vector to which the cached records are appended.
+    * @param fileStatus - An array of filenames.GetSize() entries that receives the recorded LoadStatus of each file.
+    * @return true if the cache was valid and its records were appended, false otherwise.
+    * @pre fileStatus has room for filenames.GetSize() entries.
+    * @post If false is returned, atmosData and fileStatus are unchanged.
+    */
+bool LoadAtmosCache(const std::string & cachePath, const Vector<std::string> & filenames,
+                    AtmosLogType & atmosData, LoadStatus * fileStatus);
+
+    /**
+    * @brief Writes records and the state of their source files to a cache file.
+    *
+    * The stamps must be taken before the files are parsed. A file changed during or after parsing then no longer
+    * matches its stamp, so the next LoadAtmosCache() parses it again instead of serving the records read before the
+    * change. The file is written under a temporary name and then renamed, so an interrupted write never leaves a
+    * truncated cache behind.
+    *
+    * @param cachePath - Path of the cache file.
+    * @param filenames - The file names listed in data_source.txt, in order.
+    * @param fileStamps - The stamp of each listed file, taken with GetFileStamp() before it was parsed.
+    * @param fileStatus - The LoadStatus of each listed file.
+    * @param atmosData - The records loaded from the listed files.
+    * @return true if the cache was written, false otherwise.
+    * @pre fileStamps and fileStatus hold filenames.GetSize() entries.
+    * @post If true is returned, the cache file holds the given records.
+    */
+bool SaveAtmosCache(const std::string & cachePath, const Vector<std::string> & filenames,
+                    const FileStampType * fileStamps, const LoadStatus * fileStatus, const AtmosLogType & atmosData);
+
+    /**
+    * @brief Reads the size and modification time of a file.
+    *
+    * The time keeps the sub-second part the file system records, so a rewrite of the same size within the same
+    * second still changes the stamp.
+    *
+    * @param path - Path of the file.
+    * @param stamp - Output parameter for the size and modification time, both -1 if the file does not exist.
+    * @return void
+    * @pre None.
+    * @post stamp describes the file.
+    */
+void GetFileStamp(const std::string & path, FileStampType & stamp);
+
+    /**
+    * @brief Computes a 64-bit checksum of a block of bytes.
+    *
+    * Uses FNV-1a over 8-byte words, followed by the remaining bytes, which is fast enough for cache files of
+    * hundreds of megabytes.
+    *
+    * @param data - Pointer to the first byte.
+    * @param size - Number of bytes.
+    * @return The checksum.
+    * @pre [data, data + size) is readable.
+    * @post None.
+    */
+std::uint64_t ComputeChecksum(const char * data, std::size_t size);
+
+    /**
+    * @brief Packs a Date into a 32-bit key, with the year in the high bits, then month, then day.
+    *
+    * @param d - The date to pack.
+    * @return The packed key.
+    * @pre 1 <= month <= 12, 1 <= day <= 31, year >= 0.
+    * @post None.
+    */
+std::uint32_t PackDateKey(const Date & d);
+
+    /**
+    * @brief Packs a MyTime into a 16-bit key, with the hour in the high bits and the minute in the low 6 bits.
+    *
+    * @param t - The time to pack.
+    * @return The packed key.
+    * @pre 0 <= hour <= 23, 0 <= minute <= 59.
+    * @post None.
+    */
+std::uint16_t PackTimeKey(const MyTime & t);
+
+//----------------------------------------------------------------------------------
+
+#endif // ATMOSCACHE_H
@@ -1,19 +1,16 @@
 #include "AtmosphereLogTypes.h"
 #include "Calc.h"
 #include "utils.h"
+#include <cfloat>
+#include <cmath>
 
 //---------------------------------------------------------------------------------------
 
 bool operator <(const AtmosRecType & lhs, const AtmosRecType & rhs)
 {
-    if (!(lhs.date == rhs.date))
+    if (lhs.timestamp != rhs.timestamp)
     {
-        return lhs.date < rhs.date;
-    }
-
-    if (!(lhs.time == rhs.time))
-    {
-        return lhs.time < rhs.time;
+        return lhs.timestamp < rhs.timestamp;
     }
 
     if (!CompareFloats(lhs.speed, rhs.speed))
@@ -38,14 +35,9 @@ bool operator <(const AtmosRecType & lhs, const AtmosRecType & rhs)
 
 bool operator >(const AtmosRecType & lhs, const AtmosRecType & rhs)
 {
-    if (!(lhs.date == rhs.date))
-    {
-        return lhs.date > rhs.date;
-    }
-
-    if (!(lhs.time == rhs.time))
+    if (lhs.timestamp != rhs.timestamp)
     {
-        return lhs.time > rhs.time;
+        return lhs.timestamp > rhs.timestamp;
     }
 
     if (!CompareFloats(lhs.speed, rhs.speed))
@@ -70,11 +62,156 @@ bool operator >(const AtmosRecType & lhs, const AtmosRecType & rhs)
 
 bool operator ==(const AtmosRecType & lhs, const AtmosRecType & rhs)
 {
-    return lhs.date == rhs.date &&
-           lhs.time == rhs.time &&
+    return lhs.timestamp == rhs.timestamp &&
            CompareFloats(lhs.speed, rhs.speed) &&
            CompareFloats(lhs.temperature, rhs.temperature) &&
            CompareFloats(lhs.solar_rad, rhs.solar_rad);
 }
 
 //---------------------------------------------------------------------------------------
+
+std::uint32_t MakeTimestamp(const Date & d, const MyTime & t)
+{
+    std::uint32_t months = static_cast<std::uint32_t>(d.GetYear()) * 12 + (d.GetMonth() - 1);
+    std::uint32_t days = months * 31 + (d.GetDay() - 1);
+    return (days * 24 + t.GetHour()) * 60 + t.GetMinute();
+}
+
+//---------------------------------------------------------------------------------------
+
+int TimestampMonth(std::uint32_t timestamp)
+{
+    return (timestamp / (31 * 24 * 60)) % 12 + 1;
+}
+
+//---------------------------------------------------------------------------------------
+
+int TimestampYear(std::uint32_t timestamp)
+{
+    return timestamp / (12 * 31 * 24 * 60);
+}
+
+//---------------------------------------------------------------------------------------
+
+AtmosRecType MakeRangeBound(std::uint32_t timestamp, bool upper)
+{
+    AtmosRecType bound;
+    float limit = upper ? FLT_MAX : -FLT_MAX;
+
+    bound.timestamp = timestamp;
+    bound.speed = limit;
+    bound.temperature = limit;
+    bound.solar_rad = limit;
+
+    return bound;
+}
+
+//---------------------------------------------------------------------------------------
+
+void AppendToColumns(AtmosColumns & columns, const AtmosRecType & rec)
+{
+    columns.timestamp.PushBack(rec.timestamp);
+    columns.speed.PushBack(rec.speed);
+    columns.temperature.PushBack(rec.temperature);
+    columns.solar_rad.PushBack(rec.solar_rad);
+}
+
+//---------------------------------------------------------------------------------------
+
+void IndexColumnMonths(AtmosColumns & columns)
+{
+    int count = columns.timestamp.GetSize();
+    int i = 0;
+
+    for (int month = 1; month <= 12; month++)
+    {
+        columns.monthBegin[month - 1] = i;
+        while (i < count && TimestampMonth(columns.timestamp[i]) == month)
+        {
+            i++;
+        }
+    }
+    columns.monthBegin[12] = count;
+}
+
+//---------------------------------------------------------------------------------------
+
+void SummariseColumnMonths(AtmosColumns & columns)
+{
+    for (int month = 1; month <= 12; month++)
+    {
+        MonthSummary & summary = columns.months[month - 1];
+        ResetSummary(summary.speed);
+        ResetSummary(summary.temperature);
+        ResetSummary(summary.solar_rad);
+
+        for (int i = columns.monthBegin[month - 1]; i < columns.monthBegin[month]; i++)
+        {
+            if (columns.speed[i] != -1.0f)
+            {
+                AddToSummary(summary.speed, columns.speed[i]);
+            }
+            if (columns.temperature[i] != -1.0f)
+            {
+                AddToSummary(summary.temperature, columns.temperature[i]);
+            }
+            if (columns.solar_rad[i] >= 100.0f)
+            {
+                AddToSummary(summary.solar_rad, columns.solar_rad[i]);
+            }
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------------
+
+void AddToSummary(FieldSummary & summary, float value)
+{
+    if (summary.count == 0 || value < summary.min)
+    {
+        summary.min = value;
+    }
+    if (summary.count == 0 || value > summary.max)
+    {
+        summary.max = value;
+    }
+    summary.count++;
+    summary.sum += value;
+    summary.sumSq += static_cast<double>(value) * value;
+}
+
+//---------------------------------------------------------------------------------------
+
+void ResetSummary(FieldSummary & summary)
+{
+    summary.count = 0;
+    summary.sum = 0;
+    summary.sumSq = 0;
+    summary.min = 0;
+    summary.max = 0;
+}
+
+//---------------------------------------------------------------------------------------
+
+float SummaryMean(const FieldSummary & summary)
+{
+    return static_cast<float>(summary.sum / summary.count);
+}
+
+//---------------------------------------------------------------------------------------
+
+float SummaryStandardDeviation(const FieldSummary & summary)
+{
+    if (summary.count < 2)
+    {
+        return 0; // a single value has no spread, as in GetColumnStats()
+    }
+    double squaredDiffs = summary.sumSq - summary.sum * summary.sum / summary.count;
+    if (squaredDiffs < 0)
+    {
+        squaredDiffs = 0; // rounding can push a zero spread slightly below zero
+    }
+    return static_cast<float>(std::sqrt(squaredDiffs / (summary.count - 1)));
+}
+
+//---------------------------------------------------------------------------------------
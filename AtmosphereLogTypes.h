@@ -6,6 +6,7 @@
 #include "date.h"
 #include "mytime.h"
 #include "vector.h"
+#include <cstdint>
 
 //---------------------------------------------------------------------------------------
 
@@ -13,6 +14,7 @@
 typedef struct {
     Date date; /// Represents the numeric calendar date of the atmospheric measurement. In format: dd/mm/yyyy
     MyTime time; /// Represents the time of day (in 24-hour format) when the measurement was taken. In format: HH:MM
+    std::uint32_t timestamp; /// The date and time packed by MakeTimestamp() when the record is parsed, used for ordering.
     float speed; /// Records the wind speed in meters per second.
     float temperature; /// Records the ambient air temperature in degrees Celsius.
     float solar_rad; /// Records solar radiation in W/m^2 for the date-time.
@@ -23,18 +25,184 @@ typedef struct {
 /// A Vector container storing multiple AtmosRecType records.
 typedef Vector<AtmosRecType> AtmosLogType;
 
+//---------------------------------------------------------------------------------------
+
+/// Summary statistics of the valid values of one measurement over one month.
+///
+/// The sums are kept in double precision so that the mean and standard deviation can be derived from them
+/// without the cancellation the same formula would suffer in float.
+typedef struct {
+    int count; /// Number of valid values.
+    double sum; /// Sum of the valid values.
+    double sumSq; /// Sum of the squares of the valid values.
+    float min; /// Smallest valid value, only meaningful if count > 0.
+    float max; /// Largest valid value, only meaningful if count > 0.
+} FieldSummary;
+
+/// Summary statistics of every measurement over one month.
+typedef struct {
+    FieldSummary speed; /// Wind speeds that are not missing.
+    FieldSummary temperature; /// Air temperatures that are not missing.
+    FieldSummary solar_rad; /// Solar radiation values of at least 100 W/m^2; sum is the month's solar total.
+} MonthSummary;
+
+//---------------------------------------------------------------------------------------
+
+/// A structure-of-arrays store of the atmospheric records of one year, in chronological order.
+///
+/// Each measurement lives in its own contiguous array, so a statistic over one field reads only that field.
+/// Because the records are sorted, the records of month m are the index range [monthBegin[m - 1], monthBegin[m]).
+typedef struct {
+    Vector<std::uint32_t> timestamp; /// Packed date and time of each record, see MakeTimestamp().
+    Vector<float> speed; /// Wind speed of each record in meters per second, -1.0f if missing.
+    Vector<float> temperature; /// Air temperature of each record in degrees Celsius, -1.0f if missing.
+    Vector<float> solar_rad; /// Solar radiation of each record in W/m^2, -1.0f if missing.
+    int monthBegin[13]; /// Index of the first record of each month; monthBegin[12] is the record count.
+    MonthSummary months[12]; /// Summary statistics of each month, months[m - 1] for month m.
+} AtmosColumns;
+
+//---------------------------------------------------------------------------------------
+
+/// The last year MakeTimestamp() can pack: every minute of 8016 fits in 32 bits, the end of 8017 does not.
+const int MAX_TIMESTAMP_YEAR = 8016;
+
+//---------------------------------------------------------------------------------------
+
+    /**
+    * @brief Packs a date and time into a single order-preserving 32-bit timestamp.
+    *
+    * The timestamp counts minutes in a calendar where every month has 31 days, i.e.
+    * ((((year * 12 + month - 1) * 31 + day - 1) * 24 + hour) * 60 + minute). It is not a true minute count,
+    * but comparing two timestamps gives the same result as comparing their dates and then their times,
+    * and the fields can be recovered with simple division. Years up to MAX_TIMESTAMP_YEAR fit in 32 bits.
+    *
+    * @param d - The date of the measurement.
+    * @param t - The time of the measurement.
+    * @return The packed timestamp.
+    * @pre d holds a valid date with 0 <= year <= MAX_TIMESTAMP_YEAR, t holds a valid 24-hour time.
+    * @post None.
+    */
+std::uint32_t MakeTimestamp(const Date & d, const MyTime & t);
+
+    /**
+    * @brief Returns the month (1-12) of a packed timestamp.
+    *
+    * @param timestamp - A timestamp created by MakeTimestamp().
+    * @return The month of the timestamp.
+    * @pre timestamp was created by MakeTimestamp().
+    * @post None.
+    */
+int TimestampMonth(std::uint32_t timestamp);
+
+    /**
+    * @brief Returns the year of a packed timestamp.
+    *
+    * @param timestamp - A timestamp created by MakeTimestamp().
+    * @return The year of the timestamp.
+    * @pre timestamp was created by MakeTimestamp().
+    * @post None.
+    */
+int TimestampYear(std::uint32_t timestamp);
+
+    /**
+    * @brief Creates a record that bounds every record with the given timestamp from below or above.
+    *
+    * Records with equal timestamps are ordered by their measurements, so a plain record cannot mark the edge of a
+    * time range. The bound takes the lowest (or highest) possible measurements, so that a range query from the lower
+    * bound of t1 to the upper bound of t2 includes every record with t1 <= timestamp <= t2.
+    *
+    * @param timestamp - A timestamp created by MakeTimestamp().
+    * @param upper - true for the upper bound, false for the lower bound.
+    * @return The bounding record. Only its timestamp and measurements are meaningful.
+    * @pre None.
+    * @post None.
+    */
+AtmosRecType MakeRangeBound(std::uint32_t timestamp, bool upper);
+
+    /**
+    * @brief Appends one record to the end of a columnar store.
+    *
+    * @param columns - The columnar store of the record's year.
+    * @param rec - The record to append.
+    * @return void
+    * @pre rec is not earlier than the last record already in columns.
+    * @post Each column has grown by one value. IndexColumnMonths() must be called before the month ranges are used.
+    */
+void AppendToColumns(AtmosColumns & columns, const AtmosRecType & rec);
+
+    /**
+    * @brief Computes the month ranges of a columnar store.
+    *
+    * @param columns - The columnar store to index.
+    * @return void
+    * @pre The records in columns are in chronological order and belong to a single year.
+    * @post monthBegin holds the first index of every month, and monthBegin[12] the number of records.
+    */
+void IndexColumnMonths(AtmosColumns & columns);
+
+    /**
+    * @brief Computes the summary statistics of every month of a columnar store.
+    *
+    * @param columns - The columnar store to summarise.
+    * @return void
+    * @pre IndexColumnMonths() has been called on columns.
+    * @post months[m - 1] summarises the records of month m.
+    */
+void SummariseColumnMonths(AtmosColumns & columns);
+
+    /**
+    * @brief Adds a value to a field summary.
+    *
+    * @param summary - The summary to update.
+    * @param value - The valid value to add.
+    * @return void
+    * @pre summary has been reset by ResetSummary().
+    * @post count, sum, sumSq, min and max include value.
+    */
+void AddToSummary(FieldSummary & summary, float value);
+
+    /**
+    * @brief Resets a field summary to hold no values.
+    *
+    * @param summary - The summary to reset.
+    * @return void
+    * @pre None.
+    * @post count, sum and sumSq are 0.
+    */
+void ResetSummary(FieldSummary & summary);
+
+    /**
+    * @brief Returns the mean of the values in a field summary.
+    *
+    * @param summary - The summary.
+    * @return The mean of the values.
+    * @pre summary.count > 0.
+    * @post None.
+    */
+float SummaryMean(const FieldSummary & summary);
+
+    /**
+    * @brief Returns the sample standard deviation of the values in a field summary.
+    *
+    * @param summary - The summary.
+    * @return The sample standard deviation (variance divided by count - 1), or 0 if there are fewer than two values.
+    * @pre None.
+    * @post None.
+    */
+float SummaryStandardDeviation(const FieldSummary & summary);
+
 //---------------------------------------------------------------------------------------
 
     /**
     * @brief Less-than operator for comparing two AtmosRecType objects.
     *
-    * Compares two AtmosRecType objects, comparing date, time, speed, temperature, and solar_rad in order,
-    * returning true if the left hand side is less than the right hand side.
+    * Compares two AtmosRecType objects, comparing the packed timestamp (date and time), then speed, temperature,
+    * and solar_rad in order, returning true if the left hand side is less than the right hand side.
     *
     * @param lhs - The left-hand side AtmosRecType object.
     * @param rhs - The right-hand side AtmosRecType object.
     * @return True if any of lhs data members are less than rhs data members.
-    * @pre lhs and rhs are valid AtmosRecType struct objects with valid values.
+    * @pre lhs and rhs are valid AtmosRecType struct objects with valid values, and timestamp matches date and time.
     * @post lhs and rhs remain unchanged.
     */
 bool operator <(const AtmosRecType & lhs, const AtmosRecType & rhs);
@@ -42,13 +210,13 @@ bool operator <(const AtmosRecType & lhs, const AtmosRecType & rhs);
     /**
     * @brief Greater-than operator for comparing two AtmosRecType objects.
     *
-    * Compares two AtmosRecType objects, comparing date, time, speed, temperature, and solar_rad in order,
-    * returning true if the left hand side is greater than the right hand side.
+    * Compares two AtmosRecType objects, comparing the packed timestamp (date and time), then speed, temperature,
+    * and solar_rad in order, returning true if the left hand side is greater than the right hand side.
     *
     * @param lhs - The left-hand side AtmosRecType object.
     * @param rhs - The right-hand side AtmosRecType object.
     * @return True if any of lhs data members are greater than rhs data members.
-    * @pre lhs and rhs are valid AtmosRecType struct objects with valid values.
+    * @pre lhs and rhs are valid AtmosRecType struct objects with valid values, and timestamp matches date and time.
     * @post lhs and rhs remain unchanged.
     */
 bool operator >(const AtmosRecType & lhs, const AtmosRecType & rhs);
@@ -56,13 +224,13 @@ bool operator >(const AtmosRecType & lhs, const AtmosRecType & rhs);
     /**
     * @brief Comparison operator for comparing two AtmosRecType objects.
     *
-    * Compares two AtmosRecType objects, comparing date, time, speed, temperature, and solar_rad in order,
-    * returning true if the left hand side equal to the right hand side.
+    * Compares two AtmosRecType objects, comparing the packed timestamp (date and time), then speed, temperature,
+    * and solar_rad in order, returning true if the left hand side equal to the right hand side.
     *
     * @param lhs - The left-hand side AtmosRecType object.
     * @param rhs - The right-hand side AtmosRecType object.
     * @return True if all of lhs data members are equal to rhs data members.
-    * @pre lhs and rhs are valid AtmosRecType struct objects with valid values.
+    * @pre lhs and rhs are valid AtmosRecType struct objects with valid values, and timestamp matches date and time.
     * @post lhs and rhs remain unchanged.
     */
 bool operator ==(const AtmosRecType & lhs, const AtmosRecType & rhs);
@@ -3,28 +3,52 @@
 
 //---------------------------------------------------------------------------------------
 
+#include "NodePool.h"
+#include "Vector.h"
+#include "Visitor.h"
+#include <cstddef>
+#include <cstring>
 #include <iostream>
+#include <iterator>
+#include <new>
+#include <type_traits>
 
 //---------------------------------------------------------------------------------------
 
-/// A record acting as a node of the binary search tree, containing the actual data and
-/// pointers to the left and right nodes
+/// A record acting as a node of the binary search tree, containing the actual data,
+/// pointers to the left and right nodes and the height of the subtree rooted at the node
 template <class T>
 struct Node
 {
     T data; /// The actual data in the node
     Node<T> * left; /// The pointer to the left subtree
     Node<T> * right; /// The pointer to the right subtree
+    int height; /// The number of nodes on the longest path down from this node, 1 for a leaf
 };
 
+//---------------------------------------------------------------------------------------
+
+/// The longest root-to-leaf path an AVL-balanced BST can have. An AVL tree of height h holds at least
+/// Fibonacci(h + 2) - 1 nodes, which is more than the largest int once h reaches 45.
+const int BST_MAX_HEIGHT = 48;
+
 //---------------------------------------------------------------------------------------
 
     /**
     * @class BST
     * @brief A Binary Search Tree (BST) class that stores elements in sorted order.
     *
-    * This class implements a template-based Binary Search Tree using recursive operations
-    * for insertion, searching, traversal, copying, and deleting.
+    * This class implements a template-based Binary Search Tree using iterative operations
+    * for insertion, searching, traversal, copying, and deleting. Traversals keep their path in an explicit stack
+    * on the heap instead of the call stack, so a tree made degenerate by inserting values in order cannot overflow
+    * the call stack. Iterator walks the tree in ascending order, so range-for loops and STL algorithms work on it.
+    *
+    * Insert and Remove keep the tree AVL-balanced: the heights of the two subtrees of every node differ by at most
+    * one, restored by rotations on the way back up from the changed node. Values arriving in ascending order, as
+    * readings do, therefore still give a tree of height O(log n), and both operations take O(log n).
+    *
+    * Every node is allocated from the tree's own NodePool, so nodes sit together in large slabs instead of being
+    * scattered across the heap, and destroying the tree returns the slabs at once.
     *
     * @author Nabeel
     * @version 01
@@ -38,6 +62,34 @@ struct Node
     * @version 03
     * @date 21/07/2025 Nabeel, Integrated function pointers to traversal methods
     *
+    * @author agent
+    * @version 04
+    * @date 17/10/2026 agent, Added RangeQuery with subtree pruning
+    *
+    * @author agent
+    * @version 05
+    * @date 17/10/2026 agent, Added traversals that pass a caller-supplied context to the callback
+    *
+    * @author agent
+    * @version 06
+    * @date 17/10/2026 agent, Added BuildFromSorted, and inserting a duplicate no longer deletes the subtree
+    *
+    * @author agent
+    * @version 07
+    * @date 17/10/2026 agent, Nodes come from a NodePool, released in bulk and cloned with one memcpy when possible
+    *
+    * @author agent
+    * @version 08
+    * @date 17/10/2026 agent, Made every operation iterative and added a forward Iterator with begin() and end()
+    *
+    * @author agent
+    * @version 09
+    * @date 17/10/2026 agent, Insert keeps the tree AVL-balanced, and added Remove and GetHeight
+    *
+    * @author agent
+    * @version 10
+    * @date 17/10/2026 agent, Added VisitInOrder and VisitRange taking any callable, with early termination
+    *
     * @todo Nothing
     *
     * @bug No bugs so far
@@ -46,6 +98,103 @@ struct Node
 template <class T>
 class BST {
 public:
+    /**
+    * @class Iterator
+    * @brief A forward iterator visiting the values of a BST in ascending order.
+    *
+    * The iterator holds the path of nodes whose values are still to be visited, so each increment is O(1)
+    * amortised and uses no recursion. Values are read-only, because changing one could break the tree's order.
+    * The iterator is invalidated by any change to the tree.
+    */
+    class Iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const T * pointer;
+        typedef const T & reference;
+
+        /**
+        * @brief Construct an Iterator equal to end().
+        *
+        * @pre None.
+        * @post The iterator points past the last value.
+        */
+        Iterator();
+
+        /**
+        * @brief Return the value the iterator points to.
+        *
+        * @return A const reference to the value.
+        * @pre The iterator is not equal to end().
+        * @post The iterator remains unchanged.
+        */
+        reference operator*() const;
+
+        /**
+        * @brief Access a member of the value the iterator points to.
+        *
+        * @return A pointer to the value.
+        * @pre The iterator is not equal to end().
+        * @post The iterator remains unchanged.
+        */
+        pointer operator->() const;
+
+        /**
+        * @brief Move to the next value in ascending order.
+        *
+        * @return A reference to this iterator.
+        * @pre The iterator is not equal to end().
+        * @post The iterator points to the next value, or is equal to end() if there is none.
+        */
+        Iterator & operator++();
+
+        /**
+        * @brief Move to the next value in ascending order, returning the iterator as it was.
+        *
+        * @return A copy of the iterator before it moved.
+        * @pre The iterator is not equal to end().
+        * @post The iterator points to the next value, or is equal to end() if there is none.
+        */
+        Iterator operator++(int);
+
+        /**
+        * @brief Check whether two iterators point to the same value.
+        *
+        * @param other - The iterator to compare with.
+        * @return true if both point to the same node, or both are equal to end().
+        * @pre Both iterators belong to the same tree.
+        * @post Both iterators remain unchanged.
+        */
+        bool operator==(const Iterator & other) const;
+
+        /**
+        * @brief Check whether two iterators point to different values.
+        *
+        * @param other - The iterator to compare with.
+        * @return The opposite of operator==.
+        * @pre Both iterators belong to the same tree.
+        * @post Both iterators remain unchanged.
+        */
+        bool operator!=(const Iterator & other) const;
+
+    private:
+        friend class BST<T>;
+
+        Vector<const Node<T> *> m_stack; /// The current node on top, below it the ancestors still to be visited.
+
+        /**
+        * @brief Push node and its chain of left children, so the smallest value of the subtree is on top.
+        *
+        * @param node - The root of the subtree, or nullptr.
+        * @return void
+        * @pre None.
+        * @post The leftmost node of the subtree is on top of m_stack.
+        */
+        void PushLeft(const Node<T> * node);
+    };
+
     /**
     * @brief Construct a BST object.
     *
@@ -61,6 +210,7 @@ public:
     *
     * This constructor will overload the default constructor, passing a BST object. The passed object's data is copied
     * to the constructed object's, and creating a new tree on the heap that copies the data from the passed object's array.
+    * If the nodes of other fill a single slab and Node<T> is trivially copyable, the slab is copied with one memcpy.
     *
     * @param other - the BST object to be copied.
     * @pre other is a valid constructed BST object or nullptr.
@@ -93,15 +243,44 @@ public:
     /**
     * @brief Insert a value into the BST.
     *
-    * Adds a new value into the tree while maintaining BST ordering rules.
+    * Adds a new value into the tree while maintaining BST ordering rules, then rotates the nodes on the path back
+    * to the root as needed to keep the tree balanced.
     *
     * @param val - the value to be added to the tree.
     * @return void
     * @pre val is a valid object of type T, and is not already present in the tree.
-    * @post val is added to the tree if not already present in the the tree.
+    * @post val is added to the tree if not already present in the the tree. If it is present, the tree is unchanged.
     */
     void Insert(const T & val);
 
+    /**
+    * @brief Remove a value from the BST.
+    *
+    * A node with two children takes the value of its in-order successor, whose node is removed instead. The
+    * nodes on the path back to the root are then rotated as needed to keep the tree balanced. The freed node is
+    * reused by the next Insert.
+    *
+    * @param val - the value to be removed from the tree.
+    * @return true if the value was found and removed, false if it was not in the tree.
+    * @pre val is a valid object of type T.
+    * @post val is no longer in the tree, and the tree remains balanced.
+    */
+    bool Remove(const T & val);
+
+    /**
+    * @brief Replace the contents of the BST with the values of a sorted vector.
+    *
+    * Builds a height-balanced tree in O(n) by linking the middle value of each range to the middles of its two
+    * halves, instead of inserting every value from the root. All nodes are allocated as one contiguous block,
+    * which is released when the tree is cleared or destroyed. Values equal to the one before them are skipped.
+    *
+    * @param sorted - The values to store, in ascending order.
+    * @return void
+    * @pre sorted is in ascending order.
+    * @post The tree holds each distinct value of sorted once, and the previous contents are freed.
+    */
+    void BuildFromSorted(const Vector<T> & sorted);
+
     /**
     * @brief Search for a value in the BST.
     *
@@ -112,7 +291,16 @@ public:
     * @pre val is a valid object of type T.
     * @post The BST remains unchanged.
     */
-    bool Search(const T & val);
+    bool Search(const T & val) const;
+
+    /**
+    * @brief Return the height of the tree.
+    *
+    * @return The number of nodes on the longest path from the root to a leaf, or 0 if the tree is empty.
+    * @pre None.
+    * @post The BST remains unchanged.
+    */
+    int GetHeight() const;
 
     /**
     * @brief Perform in-order traversal using a function pointer callback.
@@ -150,8 +338,140 @@ public:
     */
     void PostOrderTraversal(void (*fp)(const T &)) const;
 
+    /**
+    * @brief Visit, in ascending order, every value in the closed range [lo, hi].
+    *
+    * Subtrees that lie entirely below lo or above hi are skipped, so a query returning k values from a balanced
+    * tree of n values visits O(log n + k) nodes.
+    *
+    * @param lo - The smallest value to visit.
+    * @param hi - The largest value to visit.
+    * @param fp - A function pointer to a callback that accepts a reference to a node's data of type T.
+    * @return void
+    * @pre T supports operator< and operator>. If hi < lo, nothing is visited.
+    * @post The callback function is called on each element x with !(x < lo) and !(x > hi), in ascending order.
+    */
+    void RangeQuery(const T & lo, const T & hi, void (*fp)(const T &)) const;
+
+    /**
+    * @brief Perform in-order traversal using a function pointer callback that receives a context pointer.
+    *
+    * Traverses the BST in ascending order, calling the provided function on each node's data together with
+    * context. The callback keeps its state in the object behind context instead of in globals, so several
+    * traversals of the same tree can run at the same time on different threads.
+    *
+    * @param fp - A function pointer to a callback that accepts a reference to a node's data of type T and the context.
+    * @param context - A pointer passed unchanged to every call of fp.
+    * @return void
+    * @pre The BST object must be fully constructed and initialized.
+    * @post The callback function is called on each element in ascending order.
+    */
+    void InOrderTraversal(void (*fp)(const T &, void *), void * context) const;
+
+    /**
+    * @brief Visit, in ascending order, every value in the closed range [lo, hi], passing a context pointer.
+    *
+    * Behaves like RangeQuery(lo, hi, fp), but the callback also receives context.
+    *
+    * @param lo - The smallest value to visit.
+    * @param hi - The largest value to visit.
+    * @param fp - A function pointer to a callback that accepts a reference to a node's data of type T and the context.
+    * @param context - A pointer passed unchanged to every call of fp.
+    * @return void
+    * @pre T supports operator< and operator>. If hi < lo, nothing is visited.
+    * @post The callback function is called on each element x with !(x < lo) and !(x > hi), in ascending order.
+    */
+    void RangeQuery(const T & lo, const T & hi, void (*fp)(const T &, void *), void * context) const;
+
+    /**
+    * @brief Visit every value in ascending order with any callable.
+    *
+    * The visitor is a template parameter, so a functor or lambda is called directly and can be inlined, and keeps
+    * its state in its own members or captures. A visitor returning bool stops the traversal by returning true.
+    *
+    * @tparam Visitor The type of the callable, accepting a const T &.
+    * @param visitor - The callable to call on each value.
+    * @return true if the visitor stopped the traversal, false if every value was visited.
+    * @pre None.
+    * @post The visitor is called on each value in ascending order, up to and including the one that stopped it.
+    */
+    template <class Visitor>
+    bool VisitInOrder(Visitor && visitor) const;
+
+    /**
+    * @brief Visit, in ascending order, every value in the closed range [lo, hi] with any callable.
+    *
+    * Skips the subtrees below lo and stops at the first value above hi, like RangeQuery. A visitor returning bool
+    * stops the traversal earlier by returning true.
+    *
+    * @tparam Visitor The type of the callable, accepting a const T &.
+    * @param lo - The smallest value to visit.
+    * @param hi - The largest value to visit.
+    * @param visitor - The callable to call on each value.
+    * @return true if the visitor stopped the traversal, false if every value in the range was visited.
+    * @pre T supports operator< and operator>. If hi < lo, nothing is visited.
+    * @post The visitor is called on each value x with !(x < lo) and !(x > hi), in ascending order, up to and
+    *       including the one that stopped it.
+    */
+    template <class Visitor>
+    bool VisitRange(const T & lo, const T & hi, Visitor && visitor) const;
+
+    /**
+    * @brief Return an iterator to the smallest value of the tree.
+    *
+    * @return An iterator to the smallest value, or end() if the tree is empty.
+    * @pre None.
+    * @post The BST remains unchanged.
+    */
+    Iterator begin() const;
+
+    /**
+    * @brief Return an iterator past the largest value of the tree.
+    *
+    * @return An iterator that compares equal to any iterator that has passed the last value.
+    * @pre None.
+    * @post The BST remains unchanged.
+    */
+    Iterator end() const;
+
 private:
     Node<T> * m_root; /// A pointer to the root of the Binary Search Tree.
+    NodePool<Node<T> > m_pool; /// The storage every node of the tree is allocated from.
+
+    /**
+    * @brief Free every node of the tree at once.
+    *
+    * Runs the destructors of the values only if T needs them, then returns all of m_pool's slabs to the heap.
+    *
+    * @return void
+    * @pre None.
+    * @post The tree is empty and m_pool holds no slabs.
+    */
+    void Clear();
+
+    /**
+    * @brief Allocate a leaf node from m_pool.
+    *
+    * @param val - The value to store in the node.
+    * @return The new node, with no children.
+    * @pre val is a valid object of type T.
+    * @post The node is owned by m_pool.
+    */
+    Node<T> * NewNode(const T & val);
+
+    /**
+    * @brief Recursive helper for BuildFromSorted.
+    *
+    * Links block[start...end] into a balanced subtree whose root is the middle node.
+    *
+    * @param block - The nodes holding the values in ascending order.
+    * @param start - The index of the first node of the range.
+    * @param end - The index of the last node of the range.
+    * @return The root of the subtree, or nullptr if the range is empty.
+    * @pre start and end are within block.
+    * @post The left and right pointers of block[start...end] are set.
+    */
+    Node<T> * LinkBlock(Node<T> * block, int start, int end);
 
     /**
     * @brief Copy an entire tree from another BST.
@@ -165,94 +485,104 @@ private:
     void CopyTree(const BST<T> & other);
 
     /**
-    * @brief Recursive helper to copy tree nodes.
+    * @brief Copy the nodes of a subtree into new nodes from m_pool.
     *
-    * Recursively copies all nodes from another tree into this calling object's tree.
+    * Walks the source with an explicit stack of source nodes and their copies, linking each copy's children as
+    * they are made.
     *
-    * @param thisNode - The destination node reference.
-    * @param otherNode - The source node to copy.
-    * @return void
-    * @pre thisNode is a reference to a pointer, otherNode is a valid node or nullptr.
-    * @post A new subtree is created at thisNode with the same structure and values as otherNode.
+    * @param otherNode - The root of the subtree to copy, or nullptr.
+    * @return The root of the copy, or nullptr if otherNode is nullptr.
+    * @pre otherNode does not belong to this tree.
+    * @post A new subtree with the same structure and values as otherNode is allocated from m_pool.
     */
-    void Copy(Node<T> * & thisNode, Node<T> * otherNode);
+    Node<T> * Copy(const Node<T> * otherNode);
 
     /**
-    * @brief Recursive helper to delete all nodes in the tree.
+    * @brief Destroy all nodes in a subtree.
     *
-    * Frees memory allocated for all nodes starting from the given node.
+    * Runs the destructor of every node starting from the given node. The storage is returned to the heap by Clear().
     *
-    * @param node - The root of the subtree to delete.
+    * @param node - The root of the subtree to destroy.
     * @return void
     * @pre node is a valid node or nullptr.
-    * @post All nodes in the subtree are deleted from memory and set to nullptr.
+    * @post All nodes in the subtree are destroyed and node is set to nullptr.
     */
     void DeleteTree(Node<T> * & node);
 
     /**
-    * @brief Recursive helper for insertion.
+    * @brief Return an iterator to the smallest value of the tree that is not less than lo.
     *
-    * Inserts a value into the correct position in the BST.
+    * Only the path from the root to that value is pushed, so RangeQuery skips every subtree below lo.
     *
-    * @param node - Reference to the current node pointer.
-    * @param val - The value to insert.
-    * @pre node is a valid pointer reference, val is valid.
-    * @post val is inserted into the correct position if not present.
+    * @param lo - The value to search for.
+    * @return An iterator to the first value x with !(x < lo), or end() if there is none.
+    * @pre T supports operator<.
+    * @post The BST remains unchanged.
     */
-    void Insert(Node<T> * & node, const T & val);
+    Iterator LowerBound(const T & lo) const;
 
     /**
-    * @brief Recursive helper for search.
-    *
-    * Searches for a value in the tree.
+    * @brief Return the height of a subtree.
     *
-    * @param node - The current node to check.
-    * @param val - The value to search for.
-    * @return True if found, false if not.
-    * @pre node is a valid node or nullptr.
-    * @post The BST remains unmodified.
+    * @param node - The root of the subtree, or nullptr.
+    * @return node's height, or 0 if node is nullptr.
+    * @pre None.
+    * @post The node remains unchanged.
     */
-    bool Search(Node<T> * node, const T & val) const;
-
+    static int Height(const Node<T> * node);
 
     /**
-    * @brief Recursive helper for in-order traversal.
+    * @brief Recompute the height of a node from the heights of its children.
     *
-    * Recursively visits all nodes in ascending order and applies the callback function to each node's data.
+    * @param node - The node to update.
+    * @return void
+    * @pre node is not nullptr, and the heights of its children are correct.
+    * @post node->height is correct.
+    */
+    static void UpdateHeight(Node<T> * node);
+
+    /**
+    * @brief Rotate a subtree left, making the right child its root.
     *
-    * @param fp - A function pointer to a callback that accepts a reference to a node's data of type T.
-    * @param node - The current node being visited.
+    * @param node - The link holding the root of the subtree.
     * @return void
-    * @pre node is a valid node pointer or nullptr.
-    * @post The callback function is called on each node in in-order sequence.
+    * @pre node and node->right are not nullptr.
+    * @post node holds the former right child, and the heights of the two rotated nodes are updated.
     */
-    void InOrderTraversal(void (*fp)(const T &), Node<T> * node) const;
+    static void RotateLeft(Node<T> * & node);
 
     /**
-    * @brief Recursive helper for pre-order traversal.
+    * @brief Rotate a subtree right, making the left child its root.
     *
-    * Recursively visits the current node before its subtrees and applies the callback function to each node's data.
+    * @param node - The link holding the root of the subtree.
+    * @return void
+    * @pre node and node->left are not nullptr.
+    * @post node holds the former left child, and the heights of the two rotated nodes are updated.
+    */
+    static void RotateRight(Node<T> * & node);
+
+    /**
+    * @brief Restore the balance of a subtree whose children are balanced but may differ in height by two.
     *
-    * @param fp - A function pointer to a callback that accepts a reference to a node's data of type T.
-    * @param node - The current node being visited.
+    * @param node - The link holding the root of the subtree.
     * @return void
-    * @pre node is a valid node pointer or nullptr.
-    * @post The callback function is called on each node in pre-order sequence.
+    * @pre node is not nullptr, both its subtrees are balanced, and their heights differ by at most two.
+    * @post The subtree at node is balanced and its height is correct.
     */
-    void PreOrderTraversal(void (*fp)(const T &), Node<T> * node) const;
+    static void Rebalance(Node<T> * & node);
 
     /**
-    * @brief Recursive helper for post-order traversal.
+    * @brief Rebalance the nodes on a path from the root, working back up from the deepest.
     *
-    * Recursively visits subtrees before the current node and applies the callback function to each node's data.
+    * Stops early once a node's height is unchanged, since nothing above it can then be out of balance.
     *
-    * @param fp - A function pointer to a callback that accepts a reference to a node's data of type T.
-    * @param node - The current node being visited.
+    * @param path - The links from the root down to the parent of the node that was added or removed.
+    * @param depth - The number of links in path.
     * @return void
-    * @pre node is a valid node pointer or nullptr.
-    * @post The callback function is called on each node in post-order sequence.
+    * @pre Every link in path holds a node, and only the subtree below the last link has changed.
+    * @post The tree is balanced and every height is correct.
     */
-    void PostOrderTraversal(void (*fp)(const T &), Node<T> * node) const;
+    static void Retrace(Node<T> ** path[], int depth);
 }; // end of class
 
 //---------------------------------------------------------------------------------------
@@ -289,7 +619,7 @@ BST<T> & BST<T>::operator=(const BST<T> & other)
 template <class T>
 BST<T>::~BST()
 {
-    DeleteTree(m_root);
+    Clear();
 }
 
 //---------------------------------------------------------------------------------------
@@ -297,15 +627,122 @@ BST<T>::~BST()
 template <class T>
 void BST<T>::Insert(const T & val)
 {
-    Insert(m_root, val);
+    // Walk the link that val belongs under, remembering the links passed so the path can be rebalanced
+    Node<T> ** path[BST_MAX_HEIGHT];
+    int depth = 0;
+    Node<T> ** link = &m_root;
+    while (*link != nullptr)
+    {
+        if ((*link)->data == val)
+        {
+            std::cout << "Duplicates not allowed\n\n";
+            return;
+        }
+        path[depth++] = link;
+        link = ((*link)->data > val) ? &(*link)->left : &(*link)->right;
+    }
+    *link = NewNode(val);
+    Retrace(path, depth);
 }
 
 //---------------------------------------------------------------------------------------
 
 template <class T>
-bool BST<T>::Search(const T & val)
+bool BST<T>::Remove(const T & val)
 {
-    return Search(m_root, val);
+    Node<T> ** path[BST_MAX_HEIGHT];
+    int depth = 0;
+    Node<T> ** link = &m_root;
+    while (*link != nullptr && !((*link)->data == val))
+    {
+        path[depth++] = link;
+        link = ((*link)->data > val) ? &(*link)->left : &(*link)->right;
+    }
+    if (*link == nullptr)
+    {
+        return false;
+    }
+
+    // A node with two children takes its successor's value, and the successor's node is unlinked instead
+    Node<T> * target = *link;
+    if (target->left != nullptr && target->right != nullptr)
+    {
+        path[depth++] = link;
+        link = &target->right;
+        while ((*link)->left != nullptr)
+        {
+            path[depth++] = link;
+            link = &(*link)->left;
+        }
+        target->data = (*link)->data;
+    }
+
+    Node<T> * removed = *link;
+    *link = (removed->left != nullptr) ? removed->left : removed->right;
+    removed->~Node<T>();
+    m_pool.Free(removed);
+
+    Retrace(path, depth);
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+void BST<T>::BuildFromSorted(const Vector<T> & sorted)
+{
+    Clear();
+
+    int distinct = 0;
+    for (int i = 0; i < sorted.GetSize(); i++)
+    {
+        if (i == 0 || !(sorted[i] == sorted[i - 1]))
+        {
+            distinct++;
+        }
+    }
+    if (distinct == 0)
+    {
+        return;
+    }
+
+    Node<T> * block = m_pool.AllocateBlock(distinct);
+
+    int n = 0;
+    for (int i = 0; i < sorted.GetSize(); i++)
+    {
+        if (i == 0 || !(sorted[i] == sorted[i - 1]))
+        {
+            ::new (static_cast<void *>(&block[n])) Node<T>;
+            block[n++].data = sorted[i];
+        }
+    }
+    m_root = LinkBlock(block, 0, distinct - 1);
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+bool BST<T>::Search(const T & val) const
+{
+    const Node<T> * node = m_root;
+    while (node != nullptr)
+    {
+        if (node->data == val)
+        {
+            return true;
+        }
+        node = (node->data > val) ? node->left : node->right;
+    }
+    return false;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+int BST<T>::GetHeight() const
+{
+    return Height(m_root);
 }
 
 //---------------------------------------------------------------------------------------
@@ -313,7 +750,7 @@ bool BST<T>::Search(const T & val)
 template <class T>
 void BST<T>::InOrderTraversal(void (*fp)(const T &)) const
 {
-    InOrderTraversal(fp, m_root);
+    VisitInOrder(fp);
 }
 
 //---------------------------------------------------------------------------------------
@@ -321,7 +758,29 @@ void BST<T>::InOrderTraversal(void (*fp)(const T &)) const
 template <class T>
 void BST<T>::PreOrderTraversal(void (*fp)(const T &)) const
 {
-    PreOrderTraversal(fp, m_root);
+    if (m_root == nullptr)
+    {
+        return;
+    }
+
+    Vector<const Node<T> *> stack;
+    stack.PushBack(m_root);
+    while (stack.GetSize() > 0)
+    {
+        const Node<T> * node = stack[stack.GetSize() - 1];
+        stack.PopBack();
+        fp(node->data);
+
+        // The right child is pushed first so the left subtree is visited first
+        if (node->right != nullptr)
+        {
+            stack.PushBack(node->right);
+        }
+        if (node->left != nullptr)
+        {
+            stack.PushBack(node->left);
+        }
+    }
 }
 
 //---------------------------------------------------------------------------------------
@@ -329,141 +788,448 @@ void BST<T>::PreOrderTraversal(void (*fp)(const T &)) const
 template <class T>
 void BST<T>::PostOrderTraversal(void (*fp)(const T &)) const
 {
-    PostOrderTraversal(fp, m_root);
+    Vector<const Node<T> *> stack;
+    const Node<T> * node = m_root;
+    const Node<T> * lastVisited = nullptr;
+    while (node != nullptr || stack.GetSize() > 0)
+    {
+        if (node != nullptr)
+        {
+            stack.PushBack(node);
+            node = node->left;
+            continue;
+        }
+
+        // A node on top of the stack is visited once its right subtree is empty or has just been visited
+        const Node<T> * top = stack[stack.GetSize() - 1];
+        if (top->right != nullptr && top->right != lastVisited)
+        {
+            node = top->right;
+        }
+        else
+        {
+            fp(top->data);
+            lastVisited = top;
+            stack.PopBack();
+        }
+    }
 }
 
 //---------------------------------------------------------------------------------------
 
 template <class T>
-void BST<T>::CopyTree(const BST<T> & other)
+void BST<T>::RangeQuery(const T & lo, const T & hi, void (*fp)(const T &)) const
 {
-    DeleteTree(m_root);
-    Copy(m_root, other.m_root);
+    VisitRange(lo, hi, fp);
 }
 
 //---------------------------------------------------------------------------------------
 
 template <class T>
-void BST<T>::Copy(Node<T> * & thisNode, Node<T> * otherNode)
+void BST<T>::InOrderTraversal(void (*fp)(const T &, void *), void * context) const
 {
-    if (otherNode == nullptr)
+    VisitInOrder([fp, context](const T & val) { fp(val, context); });
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+void BST<T>::RangeQuery(const T & lo, const T & hi, void (*fp)(const T &, void *), void * context) const
+{
+    VisitRange(lo, hi, [fp, context](const T & val) { fp(val, context); });
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+template <class Visitor>
+bool BST<T>::VisitInOrder(Visitor && visitor) const
+{
+    for (Iterator it = begin(); it != end(); ++it)
     {
-        thisNode = nullptr;
+        if (CallVisitor(visitor, *it))
+        {
+            return true;
+        }
     }
-    else
+    return false;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+template <class Visitor>
+bool BST<T>::VisitRange(const T & lo, const T & hi, Visitor && visitor) const
+{
+    for (Iterator it = LowerBound(lo); it != end() && !(*it > hi); ++it)
     {
-        thisNode = new Node<T>;
-        thisNode->data = otherNode->data;
-        Copy(thisNode->left, otherNode->left);
-        Copy(thisNode->right, otherNode->right);
+        if (CallVisitor(visitor, *it))
+        {
+            return true;
+        }
     }
+    return false;
 }
 
 //---------------------------------------------------------------------------------------
 
 template <class T>
-void BST<T>::DeleteTree(Node<T> * & node)
+typename BST<T>::Iterator BST<T>::begin() const
+{
+    Iterator it;
+    it.PushLeft(m_root);
+    return it;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+typename BST<T>::Iterator BST<T>::end() const
 {
-    if (node != nullptr)
+    return Iterator();
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+void BST<T>::Clear()
+{
+    if (!std::is_trivially_destructible<T>::value)
     {
-        DeleteTree(node->left);
-        DeleteTree(node->right);
-        delete node;
-        node = nullptr;
+        DeleteTree(m_root);
     }
+    m_root = nullptr;
+    m_pool.Release();
 }
 
 //---------------------------------------------------------------------------------------
 
 template <class T>
-void BST<T>::Insert(Node<T> * & node, const T & val)
+Node<T> * BST<T>::NewNode(const T & val)
 {
-    if (node == nullptr)
+    Node<T> * node = ::new (static_cast<void *>(m_pool.Allocate())) Node<T>;
+    node->data = val;
+    node->left = nullptr;
+    node->right = nullptr;
+    node->height = 1;
+    return node;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+Node<T> * BST<T>::LinkBlock(Node<T> * block, int start, int end)
+{
+    if (start > end)
+    {
+        return nullptr;
+    }
+
+    int mid = (start + end) / 2;
+    Node<T> * node = &block[mid];
+    node->left = LinkBlock(block, start, mid - 1);
+    node->right = LinkBlock(block, mid + 1, end);
+    UpdateHeight(node);
+    return node;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+void BST<T>::CopyTree(const BST<T> & other)
+{
+    Clear();
+    int count = other.m_pool.GetUsed();
+    if (count == 0)
     {
-        node = new Node<T>;
-        node->data = val;
-        node->left = nullptr;
-        node->right = nullptr;
+        return;
     }
-    else if (node->data == val)
+
+    if (std::is_trivially_copyable<Node<T> >::value && other.m_pool.IsContiguous())
     {
-        std::cout << "Duplicates not allowed\n\n";
-        delete node;
-        node = nullptr;
+        // Copy the whole slab at once, then shift every link by the distance between the two slabs
+        const Node<T> * source = other.m_pool.GetFirstSlot();
+        Node<T> * block = m_pool.AllocateBlock(count);
+        std::memcpy(static_cast<void *>(block), static_cast<const void *>(source), sizeof(Node<T>) * count);
+        for (int i = 0; i < count; i++)
+        {
+            if (block[i].left != nullptr)
+            {
+                block[i].left = block + (block[i].left - source);
+            }
+            if (block[i].right != nullptr)
+            {
+                block[i].right = block + (block[i].right - source);
+            }
+        }
+        m_root = block + (other.m_root - source);
         return;
     }
-    else if (node->data > val)
+
+    m_pool.Reserve(count);
+    m_root = Copy(other.m_root);
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+Node<T> * BST<T>::Copy(const Node<T> * otherNode)
+{
+    if (otherNode == nullptr)
     {
-        Insert(node->left, val);
+        return nullptr;
     }
-    else
+
+    Node<T> * root = NewNode(otherNode->data);
+    root->height = otherNode->height;
+    Vector<const Node<T> *> sources;
+    Vector<Node<T> *> copies;
+    sources.PushBack(otherNode);
+    copies.PushBack(root);
+    while (sources.GetSize() > 0)
     {
-        Insert(node->right, val);
+        const Node<T> * source = sources[sources.GetSize() - 1];
+        Node<T> * copy = copies[copies.GetSize() - 1];
+        sources.PopBack();
+        copies.PopBack();
+
+        if (source->left != nullptr)
+        {
+            copy->left = NewNode(source->left->data);
+            copy->left->height = source->left->height;
+            sources.PushBack(source->left);
+            copies.PushBack(copy->left);
+        }
+        if (source->right != nullptr)
+        {
+            copy->right = NewNode(source->right->data);
+            copy->right->height = source->right->height;
+            sources.PushBack(source->right);
+            copies.PushBack(copy->right);
+        }
     }
+    return root;
 }
 
 //---------------------------------------------------------------------------------------
 
 template <class T>
-bool BST<T>::Search(Node<T> * node, const T & val) const
+void BST<T>::DeleteTree(Node<T> * & node)
 {
     if (node == nullptr)
     {
-        return false;
+        return;
+    }
+
+    Vector<Node<T> *> stack;
+    stack.PushBack(node);
+    while (stack.GetSize() > 0)
+    {
+        Node<T> * current = stack[stack.GetSize() - 1];
+        stack.PopBack();
+
+        // The storage stays in m_pool, so the children are still readable once saved before the destructor runs
+        if (current->left != nullptr)
+        {
+            stack.PushBack(current->left);
+        }
+        if (current->right != nullptr)
+        {
+            stack.PushBack(current->right);
+        }
+        current->~Node<T>();
     }
+    node = nullptr;
+}
 
-    if (node->data == val)
+//---------------------------------------------------------------------------------------
+
+template <class T>
+typename BST<T>::Iterator BST<T>::LowerBound(const T & lo) const
+{
+    // Every node passed on the way left is at least lo and is still to be visited; nodes passed on the way right
+    // are below lo and are skipped along with their left subtrees
+    Iterator it;
+    const Node<T> * node = m_root;
+    while (node != nullptr)
     {
-        return true;
+        if (node->data < lo)
+        {
+            node = node->right;
+        }
+        else
+        {
+            it.m_stack.PushBack(node);
+            node = node->left;
+        }
     }
-    else if (node->data > val)
+    return it;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+int BST<T>::Height(const Node<T> * node)
+{
+    return (node != nullptr) ? node->height : 0;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+void BST<T>::UpdateHeight(Node<T> * node)
+{
+    int leftHeight = Height(node->left);
+    int rightHeight = Height(node->right);
+    node->height = 1 + ((leftHeight > rightHeight) ? leftHeight : rightHeight);
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+void BST<T>::RotateLeft(Node<T> * & node)
+{
+    Node<T> * pivot = node->right;
+    node->right = pivot->left;
+    pivot->left = node;
+    UpdateHeight(node);
+    UpdateHeight(pivot);
+    node = pivot;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+void BST<T>::RotateRight(Node<T> * & node)
+{
+    Node<T> * pivot = node->left;
+    node->left = pivot->right;
+    pivot->right = node;
+    UpdateHeight(node);
+    UpdateHeight(pivot);
+    node = pivot;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+void BST<T>::Rebalance(Node<T> * & node)
+{
+    int balance = Height(node->left) - Height(node->right);
+    if (balance > 1)
+    {
+        // A left child leaning right is first rotated so the heavy grandchild is on the outside
+        if (Height(node->left->left) < Height(node->left->right))
+        {
+            RotateLeft(node->left);
+        }
+        RotateRight(node);
+    }
+    else if (balance < -1)
     {
-        return Search(node->left, val);
+        if (Height(node->right->right) < Height(node->right->left))
+        {
+            RotateRight(node->right);
+        }
+        RotateLeft(node);
     }
     else
     {
-        return Search(node->right, val);
+        UpdateHeight(node);
     }
-
-    return false;
 }
 
 //---------------------------------------------------------------------------------------
 
 template <class T>
-void BST<T>::InOrderTraversal(void (*fp)(const T &), Node<T> * node) const
+void BST<T>::Retrace(Node<T> ** path[], int depth)
 {
-    if (node != nullptr)
+    for (int i = depth - 1; i >= 0; i--)
     {
-        InOrderTraversal(fp, node->left);
-        fp(node->data);
-        InOrderTraversal(fp, node->right);
+        Node<T> * & node = *path[i];
+        int before = node->height;
+        Rebalance(node);
+        if (node->height == before)
+        {
+            break;
+        }
     }
 }
 
 //---------------------------------------------------------------------------------------
 
 template <class T>
-void BST<T>::PreOrderTraversal(void (*fp)(const T &), Node<T> * node) const
+BST<T>::Iterator::Iterator()
+{
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+typename BST<T>::Iterator::reference BST<T>::Iterator::operator*() const
+{
+    return m_stack[m_stack.GetSize() - 1]->data;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+typename BST<T>::Iterator::pointer BST<T>::Iterator::operator->() const
+{
+    return &m_stack[m_stack.GetSize() - 1]->data;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+typename BST<T>::Iterator & BST<T>::Iterator::operator++()
+{
+    // The next value is the smallest in the right subtree, or else the nearest ancestor still on the stack
+    const Node<T> * node = m_stack[m_stack.GetSize() - 1];
+    m_stack.PopBack();
+    PushLeft(node->right);
+    return *this;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+typename BST<T>::Iterator BST<T>::Iterator::operator++(int)
+{
+    Iterator previous = *this;
+    ++(*this);
+    return previous;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+bool BST<T>::Iterator::operator==(const Iterator & other) const
 {
-    if (node != nullptr)
+    if (m_stack.GetSize() == 0 || other.m_stack.GetSize() == 0)
     {
-        fp(node->data);
-        PreOrderTraversal(fp, node->left);
-        PreOrderTraversal(fp, node->right);
+        return m_stack.GetSize() == other.m_stack.GetSize();
     }
+    return m_stack[m_stack.GetSize() - 1] == other.m_stack[other.m_stack.GetSize() - 1];
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+bool BST<T>::Iterator::operator!=(const Iterator & other) const
+{
+    return !(*this == other);
 }
 
 //---------------------------------------------------------------------------------------
 
 template <class T>
-void BST<T>::PostOrderTraversal(void (*fp)(const T &), Node<T> * node) const
+void BST<T>::Iterator::PushLeft(const Node<T> * node)
 {
-    if (node != nullptr)
+    while (node != nullptr)
     {
-        PostOrderTraversal(fp, node->left);
-        PostOrderTraversal(fp, node->right);
-        fp(node->data);
+        m_stack.PushBack(node);
+        node = node->left;
     }
 }
 
@@ -1,7 +1,13 @@
 #include "../BST.h"
+#include "../EytzingerIndex.h"
 #include "../Date.h"
 #include "../Utils.h"
+#include "../Vector.h"
+#include <algorithm>
 #include <iostream>
+#include <iterator>
+#include <numeric>
+#include <string>
 
 //---------------------------------------------------------------------------------------
 
@@ -35,6 +41,58 @@ void TestFourteen();
 
 void TestFifteen();
 
+void TestSixteen();
+
+void TestSeventeen();
+
+void TestEighteen();
+
+void TestNineteen();
+
+void TestTwenty();
+
+void TestTwentyOne();
+
+void TestTwentyTwo();
+
+void TestTwentyThree();
+
+void TestTwentyFour();
+
+void TestTwentyFive();
+
+void TestTwentySix();
+
+void TestTwentySeven();
+
+/// A functor visitor that sums the values it is called on and stops once the sum passes a limit.
+struct SumUntil
+{
+    int limit; /// The sum at which to stop.
+    int sum; /// The sum of the values visited so far.
+    int calls; /// The number of values visited so far.
+
+    bool operator()(const int & val)
+    {
+        sum += val;
+        calls++;
+        return sum > limit;
+    }
+};
+
+void AppendInt(const int & val, void * values);
+
+bool SameValues(const Vector<int> & lhs, const Vector<int> & rhs);
+
+bool SameSet(Vector<int> values, const Vector<int> & sorted);
+
+int MaxBalancedHeight(int count);
+
+void CollectInt(const int & val);
+
+/// The values gathered by CollectInt, for traversals whose callback takes no context.
+Vector<int> s_collected;
+
 template <class T>
 void PassByValue(BST<T> bst_copy);
 
@@ -116,6 +174,54 @@ int main()
     TestFifteen(); // BST templating works with custom Date class.
     std::cout << std::endl;
 
+    std::cout << "Test Sixteen\n";
+    TestSixteen(); // Range query visits only the values within the inclusive bounds, in order.
+    std::cout << std::endl;
+
+    std::cout << "Test Seventeen\n";
+    TestSeventeen(); // Range query with no values in range, and with inverted bounds, visits nothing.
+    std::cout << std::endl;
+
+    std::cout << "Test Eighteen\n";
+    TestEighteen(); // BuildFromSorted builds a balanced tree without duplicates that can still be inserted into, searched and copied.
+    std::cout << std::endl;
+
+    std::cout << "Test Nineteen\n";
+    TestNineteen(); // BuildFromSorted replaces existing contents, and an empty vector gives an empty tree.
+    std::cout << std::endl;
+
+    std::cout << "Test Twenty\n";
+    TestTwenty(); // Copies of pooled trees, cloned in one block or node by node, are deep and independent.
+    std::cout << std::endl;
+
+    std::cout << "Test Twenty One\n";
+    TestTwentyOne(); // A BST of std::string, whose values need destructors, is copied, assigned and destroyed correctly.
+    std::cout << std::endl;
+
+    std::cout << "Test Twenty Two\n";
+    TestTwentyTwo(); // EytzingerIndex built from a BST traverses, searches and range-queries like the BST, and copies deeply.
+    std::cout << std::endl;
+
+    std::cout << "Test Twenty Three\n";
+    TestTwentyThree(); // EytzingerIndex matches BST on every search and range query for every size from 0 to 40.
+    std::cout << std::endl;
+
+    std::cout << "Test Twenty Four\n";
+    TestTwentyFour(); // BST iterators work with range-for loops and STL algorithms.
+    std::cout << std::endl;
+
+    std::cout << "Test Twenty Five\n";
+    TestTwentyFive(); // 20000 descending inserts give a balanced tree that is searched, traversed, copied and destroyed.
+    std::cout << std::endl;
+
+    std::cout << "Test Twenty Six\n";
+    TestTwentySix(); // Remove keeps the tree balanced and matches a reference set through mixed inserts and removals.
+    std::cout << std::endl;
+
+    std::cout << "Test Twenty Seven\n";
+    TestTwentySeven(); // VisitInOrder and VisitRange take lambdas and functors, and stop when the visitor returns true.
+    std::cout << std::endl;
+
     return 0;
 }
 
@@ -337,6 +443,564 @@ void TestFifteen()
 
 //---------------------------------------------------------------------------------------
 
+void TestSixteen()
+{
+    BST<int> bst;
+    bst.Insert(50);
+    bst.Insert(6);
+    bst.Insert(25);
+    bst.Insert(1);
+    bst.Insert(75);
+    bst.Insert(60);
+    bst.Insert(90);
+
+    std::cout << "Range [6, 60]: ";
+    bst.RangeQuery(6, 60, Print);
+    std::cout << std::endl;
+
+    std::cout << "Range [0, 100]: ";
+    bst.RangeQuery(0, 100, Print);
+    std::cout << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestSeventeen()
+{
+    BST<int> bst;
+    bst.Insert(50);
+    bst.Insert(6);
+    bst.Insert(25);
+
+    std::cout << "Range [26, 49]: ";
+    bst.RangeQuery(26, 49, Print);
+    std::cout << std::endl;
+
+    std::cout << "Range [50, 6]: ";
+    bst.RangeQuery(50, 6, Print);
+    std::cout << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestEighteen()
+{
+    Vector<int> sorted;
+    sorted.PushBack(1);
+    sorted.PushBack(6);
+    sorted.PushBack(6);
+    sorted.PushBack(25);
+    sorted.PushBack(50);
+    sorted.PushBack(60);
+    sorted.PushBack(75);
+    sorted.PushBack(90);
+
+    BST<int> bst;
+    bst.BuildFromSorted(sorted);
+    std::cout << "In-order: ";
+    bst.InOrderTraversal(Print);
+    std::cout << std::endl;
+    std::cout << "Pre-order: ";
+    bst.PreOrderTraversal(Print);
+    std::cout << std::endl;
+
+    bst.Insert(30);
+    bst.Insert(50);
+    std::cout << "After inserting 30 and 50: ";
+    bst.InOrderTraversal(Print);
+    std::cout << std::endl;
+
+    std::cout << (bst.Search(30) ? "30 found\n" : "30 not found\n");
+    std::cout << (bst.Search(7) ? "7 found\n" : "7 not found\n");
+
+    BST<int> copy(bst);
+    bst.BuildFromSorted(Vector<int>());
+    std::cout << "Copy after the original is emptied: ";
+    copy.InOrderTraversal(Print);
+    std::cout << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestNineteen()
+{
+    BST<int> bst;
+    bst.Insert(50);
+    bst.Insert(6);
+
+    Vector<int> sorted;
+    sorted.PushBack(2);
+    sorted.PushBack(4);
+    sorted.PushBack(8);
+    bst.BuildFromSorted(sorted);
+    std::cout << "Rebuilt: ";
+    bst.InOrderTraversal(Print);
+    std::cout << std::endl;
+
+    bst.BuildFromSorted(Vector<int>());
+    std::cout << "Empty: ";
+    bst.InOrderTraversal(Print);
+    std::cout << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestTwenty()
+{
+    Vector<int> sorted;
+    for (int i = 1; i <= 7; i++)
+    {
+        sorted.PushBack(i * 10);
+    }
+
+    // A tree built from sorted data fills one block, so it is cloned with a single copy
+    BST<int> built;
+    built.BuildFromSorted(sorted);
+    BST<int> clone(built);
+    built.Insert(5);
+    clone.Insert(75);
+    std::cout << "Built: ";
+    built.InOrderTraversal(Print);
+    std::cout << std::endl;
+    std::cout << "Clone: ";
+    clone.InOrderTraversal(Print);
+    std::cout << std::endl;
+    std::cout << "Clone pre-order: ";
+    clone.PreOrderTraversal(Print);
+    std::cout << std::endl;
+
+    // Enough inserts to spill over several slabs, so the copy is made node by node
+    BST<int> grown;
+    for (int i = 0; i < 100; i++)
+    {
+        grown.Insert((i * 37) % 100);
+    }
+    BST<int> copy;
+    copy = grown;
+    BST<int> copyOfCopy(copy);
+    grown.Insert(100);
+    copy.Insert(-1);
+
+    std::cout << "Range [95, 100] of grown: ";
+    grown.RangeQuery(95, 100, Print);
+    std::cout << std::endl;
+    std::cout << "Range [-1, 3] of copy: ";
+    copy.RangeQuery(-1, 3, Print);
+    std::cout << std::endl;
+    std::cout << "Range [-1, 3] and [95, 100] of copy of copy: ";
+    copyOfCopy.RangeQuery(-1, 3, Print);
+    copyOfCopy.RangeQuery(95, 100, Print);
+    std::cout << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestTwentyOne()
+{
+    BST<std::string> bst;
+    bst.Insert("wind");
+    bst.Insert("air");
+    bst.Insert("temperature");
+    bst.Insert("solar radiation");
+
+    BST<std::string> copy(bst);
+    BST<std::string> assigned;
+    assigned.Insert("overwritten");
+    assigned = bst;
+    bst.Insert("humidity");
+
+    std::cout << "Original: ";
+    bst.InOrderTraversal(Print);
+    std::cout << std::endl;
+    std::cout << "Copy: ";
+    copy.InOrderTraversal(Print);
+    std::cout << std::endl;
+    std::cout << "Assigned: ";
+    assigned.InOrderTraversal(Print);
+    std::cout << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestTwentyTwo()
+{
+    BST<int> bst;
+    bst.Insert(50);
+    bst.Insert(6);
+    bst.Insert(25);
+    bst.Insert(1);
+    bst.Insert(75);
+    bst.Insert(60);
+    bst.Insert(90);
+
+    EytzingerIndex<int> index;
+    index.Build(bst);
+    std::cout << "Size: " << index.GetSize() << "\n";
+    std::cout << "In-order: ";
+    index.InOrderTraversal(Print);
+    std::cout << std::endl;
+    std::cout << "Range [6, 60]: ";
+    index.RangeQuery(6, 60, Print);
+    std::cout << std::endl;
+    std::cout << "Range [26, 49]: ";
+    index.RangeQuery(26, 49, Print);
+    std::cout << std::endl;
+    std::cout << "Range [50, 6]: ";
+    index.RangeQuery(50, 6, Print);
+    std::cout << std::endl;
+    std::cout << (index.Search(75) ? "75 found\n" : "75 not found\n");
+    std::cout << (index.Search(20) ? "20 found\n" : "20 not found\n");
+
+    EytzingerIndex<int> copy(index);
+    index.Build(BST<int>());
+    std::cout << "Copy after the original is emptied: ";
+    copy.InOrderTraversal(Print);
+    std::cout << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestTwentyThree()
+{
+    bool allMatch = true;
+    for (int size = 0; size <= 40; size++)
+    {
+        // Even values only, so every odd value is a miss that falls between two stored values
+        Vector<int> sorted;
+        for (int i = 0; i < size; i++)
+        {
+            sorted.PushBack(i * 2);
+        }
+
+        BST<int> bst;
+        bst.BuildFromSorted(sorted);
+        EytzingerIndex<int> index;
+        index.Build(sorted);
+
+        Vector<int> fromBST;
+        Vector<int> fromIndex;
+        bst.InOrderTraversal(AppendInt, &fromBST);
+        index.InOrderTraversal(AppendInt, &fromIndex);
+        allMatch = allMatch && SameValues(fromBST, fromIndex);
+
+        for (int lo = -1; lo <= size * 2; lo++)
+        {
+            allMatch = allMatch && (bst.Search(lo) == index.Search(lo));
+            for (int hi = lo - 1; hi <= size * 2; hi++)
+            {
+                Vector<int> rangeBST;
+                Vector<int> rangeIndex;
+                bst.RangeQuery(lo, hi, AppendInt, &rangeBST);
+                index.RangeQuery(lo, hi, AppendInt, &rangeIndex);
+                allMatch = allMatch && SameValues(rangeBST, rangeIndex);
+            }
+        }
+    }
+    std::cout << (allMatch ? "Index matches BST\n" : "Index differs from BST\n");
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestTwentyFour()
+{
+    BST<int> bst;
+    bst.Insert(50);
+    bst.Insert(6);
+    bst.Insert(25);
+    bst.Insert(1);
+    bst.Insert(75);
+    bst.Insert(60);
+    bst.Insert(90);
+
+    std::cout << "Range-for: ";
+    for (const int & val : bst)
+    {
+        std::cout << val << " ";
+    }
+    std::cout << std::endl;
+
+    std::cout << "Sum: " << std::accumulate(bst.begin(), bst.end(), 0) << std::endl;
+    std::cout << "Count: " << std::distance(bst.begin(), bst.end()) << std::endl;
+    std::cout << "Values above 40: " << std::count_if(bst.begin(), bst.end(), [](int val) { return val > 40; })
+              << std::endl;
+
+    BST<int>::Iterator found = std::find(bst.begin(), bst.end(), 60);
+    std::cout << "find(60): " << (found != bst.end() ? *found : -1) << ", next: " << *(++found) << std::endl;
+    std::cout << "find(20) is end(): " << (std::find(bst.begin(), bst.end(), 20) == bst.end() ? "yes" : "no")
+              << std::endl;
+
+    BST<int>::Iterator it = bst.begin();
+    BST<int>::Iterator previous = it++;
+    std::cout << "Post-increment: " << *previous << " then " << *it << std::endl;
+
+    BST<int> empty;
+    std::cout << "Empty tree begin() == end(): " << (empty.begin() == empty.end() ? "yes" : "no") << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestTwentyFive()
+{
+    // Without rebalancing, descending inserts would give every node only a left child, a list 20000 nodes deep
+    const int count = 20000;
+    BST<int> bst;
+    for (int i = count - 1; i >= 0; i--)
+    {
+        bst.Insert(i);
+    }
+    std::cout << "Height: " << bst.GetHeight() << ", within AVL bound: "
+              << (bst.GetHeight() <= MaxBalancedHeight(count) ? "yes" : "no") << std::endl;
+
+    bool allFound = true;
+    for (int i = 0; i < count; i += 97)
+    {
+        allFound = allFound && bst.Search(i);
+    }
+    std::cout << (allFound && !bst.Search(count) ? "Search correct\n" : "Search wrong\n");
+
+    Vector<int> ascending;
+    for (int i = 0; i < count; i++)
+    {
+        ascending.PushBack(i);
+    }
+
+    Vector<int> inOrder;
+    bst.InOrderTraversal(AppendInt, &inOrder);
+    std::cout << (SameValues(inOrder, ascending) ? "In-order correct\n" : "In-order wrong\n");
+
+    // Pre-order starts and post-order ends at the root, and both meet every value once
+    s_collected.Clear();
+    bst.PreOrderTraversal(CollectInt);
+    Vector<int> preOrder = s_collected;
+    s_collected.Clear();
+    bst.PostOrderTraversal(CollectInt);
+    Vector<int> postOrder = s_collected;
+    bool sameRoot = preOrder.GetSize() == count && postOrder.GetSize() == count &&
+                    preOrder[0] == postOrder[count - 1];
+    std::cout << (sameRoot && SameSet(preOrder, ascending) ? "Pre-order correct\n" : "Pre-order wrong\n");
+    std::cout << (sameRoot && SameSet(postOrder, ascending) ? "Post-order correct\n" : "Post-order wrong\n");
+
+    Vector<int> range;
+    bst.RangeQuery(100, 199, AppendInt, &range);
+    std::cout << "Range [100, 199]: " << range.GetSize() << " values from " << range[0] << " to "
+              << range[range.GetSize() - 1] << std::endl;
+
+    BST<int> copy(bst);
+    bst = BST<int>();
+    Vector<int> copied;
+    for (int val : copy)
+    {
+        copied.PushBack(val);
+    }
+    std::cout << (SameValues(copied, ascending) ? "Copy correct\n" : "Copy wrong\n");
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestTwentySix()
+{
+    BST<int> bst;
+    for (int i = 1; i <= 10; i++)
+    {
+        bst.Insert(i);
+    }
+    std::cout << "1 to 10 in ascending order, pre-order: ";
+    bst.PreOrderTraversal(Print);
+    std::cout << std::endl;
+
+    std::cout << "Remove(4): " << (bst.Remove(4) ? "removed" : "not found") << std::endl;
+    std::cout << "Remove(4) again: " << (bst.Remove(4) ? "removed" : "not found") << std::endl;
+    std::cout << "Remove(10), Remove(9), Remove(8), pre-order: ";
+    bst.Remove(10);
+    bst.Remove(9);
+    bst.Remove(8);
+    bst.PreOrderTraversal(Print);
+    std::cout << std::endl;
+
+    for (int i = 1; i <= 10; i++)
+    {
+        bst.Remove(i);
+    }
+    std::cout << "After removing everything, height: " << bst.GetHeight()
+              << ", begin() == end(): " << (bst.begin() == bst.end() ? "yes" : "no") << std::endl;
+
+    // Random inserts and removals, checked against a table of which values should be present
+    const int range = 3000;
+    Vector<int> present(range);
+    for (int i = 0; i < range; i++)
+    {
+        present.PushBack(0);
+    }
+
+    unsigned int seed = 12345;
+    int count = 0;
+    bool allMatch = true;
+    for (int op = 0; op < 30000; op++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        int val = (seed >> 8) % range;
+        // Inserts outnumber removals two to one early on, then removals take over
+        bool insert = ((seed >> 4) % 3) != 0;
+        if (op >= 20000)
+        {
+            insert = !insert;
+        }
+
+        if (insert && present[val] == 0)
+        {
+            bst.Insert(val);
+            present[val] = 1;
+            count++;
+        }
+        else if (!insert)
+        {
+            allMatch = allMatch && (bst.Remove(val) == (present[val] == 1));
+            count -= present[val];
+            present[val] = 0;
+        }
+
+        if (op % 1000 == 999)
+        {
+            Vector<int> expected;
+            for (int i = 0; i < range; i++)
+            {
+                if (present[i] == 1)
+                {
+                    expected.PushBack(i);
+                }
+            }
+            Vector<int> actual;
+            bst.InOrderTraversal(AppendInt, &actual);
+            allMatch = allMatch && SameValues(actual, expected) && bst.GetHeight() <= MaxBalancedHeight(count);
+
+            BST<int> copy(bst);
+            Vector<int> copied;
+            for (int val : copy)
+            {
+                copied.PushBack(val);
+            }
+            allMatch = allMatch && SameValues(copied, expected) && copy.GetHeight() == bst.GetHeight();
+        }
+    }
+    std::cout << (allMatch ? "Balanced tree matches reference\n" : "Balanced tree differs from reference\n");
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestTwentySeven()
+{
+    BST<int> bst;
+    for (int i = 1; i <= 10; i++)
+    {
+        bst.Insert(i * 10);
+    }
+    EytzingerIndex<int> index;
+    index.Build(bst);
+
+    Vector<int> values;
+    bool stopped = bst.VisitInOrder([&values](const int & val) { values.PushBack(val); });
+    std::cout << "Lambda collected " << values.GetSize() << " values, stopped: " << (stopped ? "yes" : "no")
+              << std::endl;
+
+    int visits = 0;
+    stopped = bst.VisitRange(25, 75, [&visits](const int & val)
+    {
+        std::cout << val << " ";
+        visits++;
+        return val >= 50;
+    });
+    std::cout << "\nStopped at 50 after " << visits << " visits: " << (stopped ? "yes" : "no") << std::endl;
+
+    visits = 0;
+    stopped = index.VisitRange(25, 75, [&visits](const int & val)
+    {
+        std::cout << val << " ";
+        visits++;
+        return val >= 50;
+    });
+    std::cout << "\nIndex stopped at 50 after " << visits << " visits: " << (stopped ? "yes" : "no") << std::endl;
+
+    SumUntil bstSum = {100, 0, 0};
+    SumUntil indexSum = {100, 0, 0};
+    bst.VisitInOrder(bstSum);
+    index.VisitInOrder(indexSum);
+    std::cout << "Functor summed " << bstSum.sum << " in " << bstSum.calls << " calls, index " << indexSum.sum
+              << " in " << indexSum.calls << " calls" << std::endl;
+
+    stopped = bst.VisitRange(1000, 2000, [](const int & val) { return true; });
+    std::cout << "Empty range stopped: " << (stopped ? "yes" : "no") << std::endl;
+    std::cout << "Function pointer: ";
+    index.VisitInOrder(Print<const int>);
+    std::cout << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void AppendInt(const int & val, void * values)
+{
+    static_cast<Vector<int> *>(values)->PushBack(val);
+}
+
+//---------------------------------------------------------------------------------------
+
+void CollectInt(const int & val)
+{
+    s_collected.PushBack(val);
+}
+
+//---------------------------------------------------------------------------------------
+
+bool SameValues(const Vector<int> & lhs, const Vector<int> & rhs)
+{
+    if (lhs.GetSize() != rhs.GetSize())
+    {
+        return false;
+    }
+    for (int i = 0; i < lhs.GetSize(); i++)
+    {
+        if (lhs[i] != rhs[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+
+bool SameSet(Vector<int> values, const Vector<int> & sorted)
+{
+    if (values.GetSize() != sorted.GetSize())
+    {
+        return false;
+    }
+    if (values.GetSize() > 0)
+    {
+        std::sort(&values[0], &values[0] + values.GetSize());
+    }
+    return SameValues(values, sorted);
+}
+
+//---------------------------------------------------------------------------------------
+
+int MaxBalancedHeight(int count)
+{
+    // The fewest nodes an AVL tree of height h can hold follows the Fibonacci numbers: N(h) = N(h-1) + N(h-2) + 1
+    int height = 0;
+    int fewest = 0;
+    int fewestBelow = 0;
+    while (fewest <= count)
+    {
+        int next = fewest + fewestBelow + 1;
+        fewestBelow = fewest;
+        fewest = next;
+        height++;
+    }
+    return height - 1;
+}
+
+//---------------------------------------------------------------------------------------
+
 template <class T>
 void PassByValue(BST<T> bst_copy)
 {
@@ -0,0 +1,323 @@
+#include "../FileIO.h"
+#include "../BST.h"
+#include "../EytzingerIndex.h"
+#include "../Sort.h"
+#include <chrono>
+#include <iostream>
+
+//---------------------------------------------------------------------------------------
+
+const char * const BENCH_NAME = "Metdata-Jan-Dec2007.csv";
+const int REPETITIONS = 5;
+const int DECADE_YEARS = 10;
+const int QUERY_COUNT = 200000;
+const int RANGE_COUNT = 20000;
+const int MINUTES_PER_DAY = 24 * 60;
+
+//---------------------------------------------------------------------------------------
+
+typedef std::chrono::steady_clock Clock;
+
+double ElapsedMs(Clock::time_point start);
+
+void BuildDecade(const AtmosLogType & year, AtmosLogType & decade);
+
+void CountRecord(const AtmosRecType & rec, void * count);
+
+void SumSpeed(const AtmosRecType & rec, void * sum);
+
+unsigned int NextRandom(unsigned int & seed);
+
+template <class Tree>
+double TimeSearches(const Tree & tree, const AtmosLogType & queries, int & found);
+
+template <class Tree>
+double TimeRanges(const Tree & tree, const AtmosLogType & bounds, int & visited);
+
+template <class Tree>
+double TimeVisitRanges(const Tree & tree, const AtmosLogType & bounds, int & visited);
+
+//---------------------------------------------------------------------------------------
+
+int main()
+{
+    std::cout << "BST Benchmark\n";
+
+    AtmosLogType year;
+    if (LoadMappedFile(BENCH_NAME, year) != LOAD_OK)
+    {
+        std::cout << "Unable to load " << BENCH_NAME << std::endl;
+        return 1;
+    }
+
+    // Ten copies of the year under different year numbers, in time order
+    AtmosLogType sorted;
+    BuildDecade(year, sorted);
+    std::cout << "Records: " << sorted.GetSize() << ", best of " << REPETITIONS << " runs\n\n";
+
+    double insertMs = -1, buildMs = -1, copyMs = -1, insertedCopyMs = -1, destroyMs = -1, removeMs = -1;
+    int visited = 0, insertedHeight = 0;
+    for (int run = 0; run < REPETITIONS; run++)
+    {
+        // Records arrive in time order, the worst order for a tree that does not rebalance
+        Clock::time_point start = Clock::now();
+        BST<AtmosRecType> * inserted = new BST<AtmosRecType>;
+        for (int i = 0; i < sorted.GetSize(); i++)
+        {
+            inserted->Insert(sorted[i]);
+        }
+        double ms = ElapsedMs(start);
+        insertMs = (insertMs < 0 || ms < insertMs) ? ms : insertMs;
+        insertedHeight = inserted->GetHeight();
+
+        start = Clock::now();
+        BST<AtmosRecType> built;
+        built.BuildFromSorted(sorted);
+        ms = ElapsedMs(start);
+        buildMs = (buildMs < 0 || ms < buildMs) ? ms : buildMs;
+
+        start = Clock::now();
+        BST<AtmosRecType> copy(built);
+        ms = ElapsedMs(start);
+        copyMs = (copyMs < 0 || ms < copyMs) ? ms : copyMs;
+
+        start = Clock::now();
+        BST<AtmosRecType> insertedCopy(*inserted);
+        ms = ElapsedMs(start);
+        insertedCopyMs = (insertedCopyMs < 0 || ms < insertedCopyMs) ? ms : insertedCopyMs;
+
+        visited = 0;
+        copy.InOrderTraversal(CountRecord, &visited);
+
+        start = Clock::now();
+        delete inserted;
+        ms = ElapsedMs(start);
+        destroyMs = (destroyMs < 0 || ms < destroyMs) ? ms : destroyMs;
+
+        // Remove the oldest records one at a time, as a rolling window would
+        start = Clock::now();
+        for (int i = 0; i < sorted.GetSize(); i++)
+        {
+            insertedCopy.Remove(sorted[i]);
+        }
+        ms = ElapsedMs(start);
+        removeMs = (removeMs < 0 || ms < removeMs) ? ms : removeMs;
+    }
+
+    std::cout << "Insert one record at a time:    " << insertMs << " ms, height " << insertedHeight << "\n";
+    std::cout << "BuildFromSorted:                " << buildMs << " ms\n";
+    std::cout << "Copy of built tree:             " << copyMs << " ms\n";
+    std::cout << "Copy of inserted tree:          " << insertedCopyMs << " ms\n";
+    std::cout << "Destroy inserted tree:          " << destroyMs << " ms\n";
+    std::cout << "Remove one record at a time:    " << removeMs << " ms\n";
+
+    if (visited != sorted.GetSize())
+    {
+        std::cout << "MISMATCH: copy holds " << visited << " records" << std::endl;
+        return 1;
+    }
+    std::cout << "Copy holds every record\n\n";
+
+    // A full ascending walk summing one field, through the callback and through the iterator
+    BST<AtmosRecType> walked;
+    walked.BuildFromSorted(sorted);
+    double callbackMs = -1, iteratorMs = -1, lambdaMs = -1;
+    double callbackSum = 0, iteratorSum = 0, lambdaSum = 0;
+    for (int run = 0; run < REPETITIONS; run++)
+    {
+        callbackSum = 0;
+        Clock::time_point start = Clock::now();
+        walked.InOrderTraversal(SumSpeed, &callbackSum);
+        double ms = ElapsedMs(start);
+        callbackMs = (callbackMs < 0 || ms < callbackMs) ? ms : callbackMs;
+
+        iteratorSum = 0;
+        start = Clock::now();
+        for (const AtmosRecType & rec : walked)
+        {
+            iteratorSum += rec.speed;
+        }
+        ms = ElapsedMs(start);
+        iteratorMs = (iteratorMs < 0 || ms < iteratorMs) ? ms : iteratorMs;
+
+        lambdaSum = 0;
+        start = Clock::now();
+        walked.VisitInOrder([&lambdaSum](const AtmosRecType & rec) { lambdaSum += rec.speed; });
+        ms = ElapsedMs(start);
+        lambdaMs = (lambdaMs < 0 || ms < lambdaMs) ? ms : lambdaMs;
+    }
+
+    std::cout << "In-order walk, callback:        " << callbackMs << " ms\n";
+    std::cout << "In-order walk, range-for:       " << iteratorMs << " ms\n";
+    std::cout << "In-order walk, VisitInOrder:    " << lambdaMs << " ms\n";
+    if (callbackSum != iteratorSum || callbackSum != lambdaSum)
+    {
+        std::cout << "MISMATCH: sums " << callbackSum << ", " << iteratorSum << " and " << lambdaSum << std::endl;
+        return 1;
+    }
+    std::cout << "Both walks agree\n\n";
+
+    BST<AtmosRecType> tree;
+    tree.BuildFromSorted(sorted);
+    EytzingerIndex<AtmosRecType> index;
+    index.Build(tree);
+
+    // Random records to look up, and random day-long ranges as pairs of lower and upper bounds
+    unsigned int seed = 12345;
+    AtmosLogType queries;
+    AtmosLogType bounds;
+    for (int i = 0; i < QUERY_COUNT; i++)
+    {
+        queries.PushBack(sorted[NextRandom(seed) % sorted.GetSize()]);
+    }
+    for (int i = 0; i < RANGE_COUNT; i++)
+    {
+        std::uint32_t from = sorted[NextRandom(seed) % sorted.GetSize()].timestamp;
+        bounds.PushBack(MakeRangeBound(from, false));
+        bounds.PushBack(MakeRangeBound(from + MINUTES_PER_DAY - 1, true));
+    }
+
+    int treeFound = 0, indexFound = 0, treeVisited = 0, indexVisited = 0;
+    double treeSearchMs = TimeSearches(tree, queries, treeFound);
+    double indexSearchMs = TimeSearches(index, queries, indexFound);
+    double treeRangeMs = TimeRanges(tree, bounds, treeVisited);
+    double indexRangeMs = TimeRanges(index, bounds, indexVisited);
+    int lambdaVisited = 0;
+    double lambdaRangeMs = TimeVisitRanges(index, bounds, lambdaVisited);
+
+    std::cout << QUERY_COUNT << " searches, BST:            " << treeSearchMs << " ms\n";
+    std::cout << QUERY_COUNT << " searches, EytzingerIndex: " << indexSearchMs << " ms\n";
+    if (indexSearchMs > 0)
+    {
+        std::cout << "Search speedup: " << (treeSearchMs / indexSearchMs) << "x\n";
+    }
+    std::cout << RANGE_COUNT << " day ranges, BST:            " << treeRangeMs << " ms\n";
+    std::cout << RANGE_COUNT << " day ranges, EytzingerIndex: " << indexRangeMs << " ms\n";
+    if (indexRangeMs > 0)
+    {
+        std::cout << "Range speedup: " << (treeRangeMs / indexRangeMs) << "x\n";
+    }
+    std::cout << RANGE_COUNT << " day ranges, EytzingerIndex::VisitRange with a lambda: " << lambdaRangeMs << " ms\n";
+
+    if (treeFound != QUERY_COUNT || indexFound != QUERY_COUNT || treeVisited != indexVisited ||
+        lambdaVisited != indexVisited)
+    {
+        std::cout << "MISMATCH: found " << treeFound << " and " << indexFound << ", visited " << treeVisited
+                  << " and " << indexVisited << std::endl;
+        return 1;
+    }
+    std::cout << "Both find every record and visit the same ranges\n";
+
+    return 0;
+}
+
+//---------------------------------------------------------------------------------------
+
+double ElapsedMs(Clock::time_point start)
+{
+    std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+    return elapsed.count();
+}
+
+//---------------------------------------------------------------------------------------
+
+void BuildDecade(const AtmosLogType & year, AtmosLogType & decade)
+{
+    decade.Reserve(year.GetSize() * DECADE_YEARS);
+    for (int y = 0; y < DECADE_YEARS; y++)
+    {
+        for (int i = 0; i < year.GetSize(); i++)
+        {
+            AtmosRecType rec = year[i];
+            rec.date.SetYear(rec.date.GetYear() - DECADE_YEARS + 1 + y);
+            rec.timestamp = MakeTimestamp(rec.date, rec.time);
+            decade.PushBack(rec);
+        }
+    }
+    MergeSort(decade, 0, decade.GetSize() - 1);
+}
+
+//---------------------------------------------------------------------------------------
+
+void CountRecord(const AtmosRecType & rec, void * count)
+{
+    (*static_cast<int *>(count))++;
+}
+
+//---------------------------------------------------------------------------------------
+
+void SumSpeed(const AtmosRecType & rec, void * sum)
+{
+    *static_cast<double *>(sum) += rec.speed;
+}
+
+//---------------------------------------------------------------------------------------
+
+unsigned int NextRandom(unsigned int & seed)
+{
+    // Fixed-seed linear congruential generator, so every run makes the same queries
+    seed = seed * 1103515245u + 12345u;
+    return seed >> 8;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class Tree>
+double TimeSearches(const Tree & tree, const AtmosLogType & queries, int & found)
+{
+    double best = -1;
+    for (int run = 0; run < REPETITIONS; run++)
+    {
+        found = 0;
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < queries.GetSize(); i++)
+        {
+            found += tree.Search(queries[i]) ? 1 : 0;
+        }
+        double ms = ElapsedMs(start);
+        best = (best < 0 || ms < best) ? ms : best;
+    }
+    return best;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class Tree>
+double TimeRanges(const Tree & tree, const AtmosLogType & bounds, int & visited)
+{
+    double best = -1;
+    for (int run = 0; run < REPETITIONS; run++)
+    {
+        visited = 0;
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i + 1 < bounds.GetSize(); i += 2)
+        {
+            tree.RangeQuery(bounds[i], bounds[i + 1], CountRecord, &visited);
+        }
+        double ms = ElapsedMs(start);
+        best = (best < 0 || ms < best) ? ms : best;
+    }
+    return best;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class Tree>
+double TimeVisitRanges(const Tree & tree, const AtmosLogType & bounds, int & visited)
+{
+    double best = -1;
+    for (int run = 0; run < REPETITIONS; run++)
+    {
+        visited = 0;
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i + 1 < bounds.GetSize(); i += 2)
+        {
+            tree.VisitRange(bounds[i], bounds[i + 1], [&visited](const AtmosRecType & rec) { visited++; });
+        }
+        double ms = ElapsedMs(start);
+        best = (best < 0 || ms < best) ? ms : best;
+    }
+    return best;
+}
+
+//---------------------------------------------------------------------------------------
@@ -0,0 +1,285 @@
+#include "../Calc.h"
+#include "../FloatKernels.h"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+//---------------------------------------------------------------------------------------
+
+const int COLUMN_SIZE = 8 * 1024 * 1024;
+const int REPETITIONS = 5;
+const double AGREEMENT = 1e-9;
+
+//---------------------------------------------------------------------------------------
+
+/// The result and the best time of one kernel at one instruction set.
+typedef struct {
+    double result; /// The value the kernel returned.
+    int count; /// The count stored by sumSkipping, 0 for the other kernels.
+    double ms; /// The best time over REPETITIONS runs, in milliseconds.
+} KernelRunType;
+
+void BuildColumn(Vector<float> & column, float base, float range, bool missing);
+
+KernelRunType TimeKernel(const FloatKernels & kernels, int kernel, const Vector<float> & x, const Vector<float> & y);
+
+double TimeTemplateTotal(const Vector<float> & x, float & result);
+
+double TimeSeparateStats(const Vector<float> & x, ColumnStats & result);
+
+double TimeFusedStats(const Vector<float> & x, ColumnStats & result);
+
+bool Agrees(double a, double b);
+
+//---------------------------------------------------------------------------------------
+
+const int KERNEL_COUNT = 5;
+const char * const KERNEL_NAMES[KERNEL_COUNT] = {
+    "sum           ", "sumSquaredDiff", "sumCrossDiff  ", "sumAbsDiff    ", "sumSkipping   "
+};
+/// The number of floats each kernel reads per element, for the bandwidth figures.
+const int KERNEL_STREAMS[KERNEL_COUNT] = {1, 1, 2, 1, 1};
+
+//---------------------------------------------------------------------------------------
+
+int main()
+{
+    std::cout << "Calc Benchmark\n";
+
+    // Synthetic wind speed and temperature columns, far longer than a year of 10-minute readings
+    Vector<float> speed;
+    Vector<float> temperature;
+    BuildColumn(speed, 0.0f, 30.0f, true);
+    BuildColumn(temperature, -5.0f, 40.0f, false);
+    std::cout << "Column: " << COLUMN_SIZE << " floats, best of " << REPETITIONS << " runs, best level: "
+              << GetFloatKernels(GetBestKernelLevel()).name << "\n\n";
+
+    float templateTotal = 0;
+    double templateMs = TimeTemplateTotal(speed, templateTotal);
+    std::cout << "CalculateTotal<float>, float accumulator: " << templateMs << " ms\n\n";
+
+    KernelRunType scalar[KERNEL_COUNT];
+    for (int level = KERNEL_SCALAR; level <= KERNEL_AVX2; level++)
+    {
+        if (!IsKernelLevelSupported(static_cast<KernelLevel>(level)))
+        {
+            std::cout << "Level " << level << " not supported by this processor, skipped\n\n";
+            continue;
+        }
+        const FloatKernels & kernels = GetFloatKernels(static_cast<KernelLevel>(level), SUMMATION_DOUBLE);
+        std::cout << kernels.name << "\n";
+
+        for (int k = 0; k < KERNEL_COUNT; k++)
+        {
+            KernelRunType run = TimeKernel(kernels, k, speed, temperature);
+            if (level == KERNEL_SCALAR)
+            {
+                scalar[k] = run;
+            }
+
+            double bytes = static_cast<double>(COLUMN_SIZE) * KERNEL_STREAMS[k] * sizeof(float);
+            std::cout << "  " << KERNEL_NAMES[k] << ": " << run.ms << " ms, ";
+            if (run.ms > 0)
+            {
+                std::cout << (bytes / run.ms / 1e6) << " GB/s, " << (scalar[k].ms / run.ms) << "x scalar";
+            }
+            std::cout << "\n";
+
+            if (!Agrees(run.result, scalar[k].result) || run.count != scalar[k].count)
+            {
+                std::cout << "MISMATCH in " << KERNEL_NAMES[k] << ": " << run.result << " against "
+                          << scalar[k].result << std::endl;
+                return 1;
+            }
+        }
+        std::cout << "\n";
+    }
+
+    // The compensated and pairwise policies only add a step per block of SUMMATION_BLOCK values
+    const FloatKernels & plain = GetBestFloatKernels(SUMMATION_DOUBLE);
+    KernelRunType plainSum = TimeKernel(plain, 0, speed, temperature);
+    std::cout << "Summation policies at " << plain.name << "\n";
+    for (int policy = SUMMATION_DOUBLE; policy <= SUMMATION_PAIRWISE; policy++)
+    {
+        const FloatKernels & kernels = GetBestFloatKernels(static_cast<SummationPolicy>(policy));
+        KernelRunType sum = TimeKernel(kernels, 0, speed, temperature);
+        KernelRunType squared = TimeKernel(kernels, 1, speed, temperature);
+        std::cout << "  " << GetSummationPolicyName(kernels.policy) << ": sum " << sum.ms << " ms, sumSquaredDiff "
+                  << squared.ms << " ms";
+        if (plainSum.ms > 0)
+        {
+            std::cout << ", sum " << (sum.ms / plainSum.ms) << "x the double policy";
+        }
+        std::cout << "\n";
+
+        if (!Agrees(sum.result, scalar[0].result) || !Agrees(squared.result, scalar[1].result))
+        {
+            std::cout << "MISMATCH in the " << GetSummationPolicyName(kernels.policy) << " policy" << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "\n";
+
+    // Mean, standard deviation and MAD: four reads of the column when called one by one, two when fused
+    ColumnStats separate;
+    ColumnStats fused;
+    double separateMs = TimeSeparateStats(temperature, separate);
+    double fusedMs = TimeFusedStats(temperature, fused);
+    std::cout << "Mean, stddev and MAD, separate calls: " << separateMs << " ms\n";
+    std::cout << "Mean, stddev and MAD, CalculateColumnStats: " << fusedMs << " ms\n";
+    if (fusedMs > 0)
+    {
+        std::cout << "Speedup: " << (separateMs / fusedMs) << "x\n";
+    }
+    if (!Agrees(separate.mean, fused.mean) || std::fabs(separate.stddev - fused.stddev) > 1e-4f ||
+        std::fabs(separate.mad - fused.mad) > 1e-4f)
+    {
+        std::cout << "MISMATCH in the fused statistics" << std::endl;
+        return 1;
+    }
+    std::cout << "\n";
+
+    // The float running total of the template drifts over millions of values, the double lanes do not
+    std::cout << "CalculateTotal<float> total: " << templateTotal << ", kernel total: " << scalar[0].result
+              << "\n";
+    std::cout << "All levels agree\n";
+
+    return 0;
+}
+
+//---------------------------------------------------------------------------------------
+
+void BuildColumn(Vector<float> & column, float base, float range, bool missing)
+{
+    // Fixed-seed linear congruential generator, so every run reads the same column
+    unsigned int seed = missing ? 12345u : 54321u;
+    column.Reserve(COLUMN_SIZE);
+    for (int i = 0; i < COLUMN_SIZE; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        float value = base + range * static_cast<float>((seed >> 8) & 0xffff) / 65535.0f;
+        // About one reading in a hundred is missing, as in the station files
+        if (missing && (seed >> 24) % 100 == 0)
+        {
+            value = -1.0f;
+        }
+        column.PushBack(value);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+
+KernelRunType TimeKernel(const FloatKernels & kernels, int kernel, const Vector<float> & x, const Vector<float> & y)
+{
+    const float * px = x.GetData();
+    const float * py = y.GetData();
+    int n = x.GetSize();
+
+    KernelRunType run;
+    run.result = 0;
+    run.count = 0;
+    run.ms = -1;
+    for (int rep = 0; rep < REPETITIONS; rep++)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        switch (kernel)
+        {
+        case 0:
+            run.result = kernels.sum(px, n);
+            break;
+        case 1:
+            run.result = kernels.sumSquaredDiff(px, n, 15.0f);
+            break;
+        case 2:
+            run.result = kernels.sumCrossDiff(px, py, n, 15.0f, 15.0f);
+            break;
+        case 3:
+            run.result = kernels.sumAbsDiff(px, n, 15.0f);
+            break;
+        default:
+            run.result = kernels.sumSkipping(px, n, -1.0f, &run.count);
+            break;
+        }
+
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        if (run.ms < 0 || elapsed.count() < run.ms)
+        {
+            run.ms = elapsed.count();
+        }
+    }
+    return run;
+}
+
+//---------------------------------------------------------------------------------------
+
+double TimeTemplateTotal(const Vector<float> & x, float & result)
+{
+    double best = -1;
+    for (int rep = 0; rep < REPETITIONS; rep++)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        result = CalculateTotal<float>(x, x.GetSize());
+
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        if (best < 0 || elapsed.count() < best)
+        {
+            best = elapsed.count();
+        }
+    }
+    return best;
+}
+
+//---------------------------------------------------------------------------------------
+
+bool Agrees(double a, double b)
+{
+    // The levels add the values in different orders, so only the last bits may differ
+    return std::fabs(a - b) <= AGREEMENT * std::fmax(1.0, std::fabs(b));
+}
+
+//---------------------------------------------------------------------------------------
+
+double TimeSeparateStats(const Vector<float> & x, ColumnStats & result)
+{
+    double best = -1;
+    for (int rep = 0; rep < REPETITIONS; rep++)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        result.count = x.GetSize();
+        result.mean = CalculateMean(x, x.GetSize());
+        result.stddev = CalculateStandardDeviation(x, x.GetSize(), result.mean);
+        result.mad = MAD(x, x.GetSize());
+
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        if (best < 0 || elapsed.count() < best)
+        {
+            best = elapsed.count();
+        }
+    }
+    return best;
+}
+
+//---------------------------------------------------------------------------------------
+
+double TimeFusedStats(const Vector<float> & x, ColumnStats & result)
+{
+    double best = -1;
+    for (int rep = 0; rep < REPETITIONS; rep++)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        result = CalculateColumnStats(x, 0, x.GetSize(), -1.0f);
+
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        if (best < 0 || elapsed.count() < best)
+        {
+            best = elapsed.count();
+        }
+    }
+    return best;
+}
+
+//---------------------------------------------------------------------------------------
@@ -0,0 +1,219 @@
+#include "../FileIO.h"
+#include "../MappedFile.h"
+#include "../Utils.h"
+#include "../Parallel.h"
+#include "../AtmosCache.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+//---------------------------------------------------------------------------------------
+
+const char * const BENCH_NAME = "Metdata-Jan-Dec2007.csv";
+const char * const BENCH_FILE = "data/Metdata-Jan-Dec2007.csv";
+const char * const BENCH_CACHE = "data/LoadBenchmark.bin";
+const int REPETITIONS = 20;
+
+//---------------------------------------------------------------------------------------
+
+double TimeStreamIngest(AtmosLogType & result);
+
+double TimeMappedIngest(AtmosLogType & result);
+
+double TimeChunkedIngest(AtmosLogType & result);
+
+double TimeCacheIngest(const AtmosLogType & source, AtmosLogType & result);
+
+bool SameRecords(const AtmosLogType & lhs, const AtmosLogType & rhs);
+
+//---------------------------------------------------------------------------------------
+
+int main()
+{
+    std::cout << "Load Benchmark\n";
+    std::cout << "File: " << BENCH_FILE << ", best of " << REPETITIONS << " runs\n\n";
+
+    AtmosLogType streamData, mappedData, chunkedData;
+    double streamMs = TimeStreamIngest(streamData);
+    double mappedMs = TimeMappedIngest(mappedData);
+    double chunkedMs = TimeChunkedIngest(chunkedData);
+    AtmosLogType cachedData;
+    double cacheMs = TimeCacheIngest(streamData, cachedData);
+
+    std::cout << "Stream ingest (ifstream + getline + stof): " << streamMs << " ms, "
+              << streamData.GetSize() << " records\n";
+    std::cout << "Mapped ingest (mmap + in-place scanning):  " << mappedMs << " ms, "
+              << mappedData.GetSize() << " records\n";
+    std::cout << "Chunked ingest (mmap, workers: " << GetWorkerCount(1 << 30) << "):    " << chunkedMs << " ms, "
+              << chunkedData.GetSize() << " records\n";
+    std::cout << "Warm binary cache (mmap + checksum):      " << cacheMs << " ms, "
+              << cachedData.GetSize() << " records\n";
+    if (mappedMs > 0 && chunkedMs > 0 && cacheMs > 0)
+    {
+        std::cout << "Speedup (mapped): " << (streamMs / mappedMs) << "x\n";
+        std::cout << "Speedup (chunked): " << (streamMs / chunkedMs) << "x\n";
+        std::cout << "Speedup (cache): " << (streamMs / cacheMs) << "x\n";
+    }
+
+    if (SameRecords(streamData, mappedData) && SameRecords(streamData, chunkedData) &&
+        SameRecords(streamData, cachedData))
+    {
+        std::cout << "All paths produced identical records\n";
+    }
+    else
+    {
+        std::cout << "MISMATCH between stream, mapped, chunked and cached records\n";
+        return 1;
+    }
+
+    return 0;
+}
+
+//---------------------------------------------------------------------------------------
+
+double TimeStreamIngest(AtmosLogType & result)
+{
+    double best = -1;
+    for (int run = 0; run < REPETITIONS; run++)
+    {
+        AtmosLogType data;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        std::ifstream inFile(BENCH_FILE);
+        if (!inFile)
+        {
+            std::cout << "Unable to open " << BENCH_FILE << std::endl;
+            return 0;
+        }
+        ReadAtmosphereData(inFile, data);
+
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        if (best < 0 || elapsed.count() < best)
+        {
+            best = elapsed.count();
+        }
+        result = data;
+    }
+    return best;
+}
+
+//---------------------------------------------------------------------------------------
+
+double TimeMappedIngest(AtmosLogType & result)
+{
+    double best = -1;
+    for (int run = 0; run < REPETITIONS; run++)
+    {
+        AtmosLogType data;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        MappedFile inFile;
+        if (!inFile.Open(BENCH_FILE))
+        {
+            std::cout << "Unable to open " << BENCH_FILE << std::endl;
+            return 0;
+        }
+        ParseAtmosphereBuffer(inFile.GetData(), inFile.GetData() + inFile.GetSize(), data);
+
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        if (best < 0 || elapsed.count() < best)
+        {
+            best = elapsed.count();
+        }
+        result = data;
+    }
+    return best;
+}
+
+//---------------------------------------------------------------------------------------
+
+double TimeChunkedIngest(AtmosLogType & result)
+{
+    double best = -1;
+    for (int run = 0; run < REPETITIONS; run++)
+    {
+        AtmosLogType data;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        MappedFile inFile;
+        if (!inFile.Open(BENCH_FILE))
+        {
+            std::cout << "Unable to open " << BENCH_FILE << std::endl;
+            return 0;
+        }
+        ParseAtmosphereBufferChunked(inFile.GetData(), inFile.GetData() + inFile.GetSize(), data);
+
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        if (best < 0 || elapsed.count() < best)
+        {
+            best = elapsed.count();
+        }
+        result = data;
+    }
+    return best;
+}
+
+//---------------------------------------------------------------------------------------
+
+double TimeCacheIngest(const AtmosLogType & source, AtmosLogType & result)
+{
+    Vector<std::string> filenames;
+    filenames.PushBack(BENCH_NAME);
+    LoadStatus fileStatus[1] = {LOAD_OK};
+    FileStampType fileStamps[1];
+    GetFileStamp(std::string("data/") + BENCH_NAME, fileStamps[0]);
+
+    if (!SaveAtmosCache(BENCH_CACHE, filenames, fileStamps, fileStatus, source))
+    {
+        std::cout << "Unable to write " << BENCH_CACHE << std::endl;
+        return 0;
+    }
+
+    double best = -1;
+    for (int run = 0; run < REPETITIONS; run++)
+    {
+        AtmosLogType data;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        if (!LoadAtmosCache(BENCH_CACHE, filenames, data, fileStatus))
+        {
+            std::cout << "Cache rejected\n";
+            break;
+        }
+
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        if (best < 0 || elapsed.count() < best)
+        {
+            best = elapsed.count();
+        }
+        result = data;
+    }
+
+    std::remove(BENCH_CACHE);
+    return best;
+}
+
+//---------------------------------------------------------------------------------------
+
+bool SameRecords(const AtmosLogType & lhs, const AtmosLogType & rhs)
+{
+    if (lhs.GetSize() != rhs.GetSize())
+    {
+        return false;
+    }
+
+    // Compare bit-for-bit rather than with the epsilon used by operator==
+    for (int i = 0; i < lhs.GetSize(); i++)
+    {
+        if (!(lhs[i].date == rhs[i].date) || !(lhs[i].time == rhs[i].time) ||
+            lhs[i].speed != rhs[i].speed || lhs[i].temperature != rhs[i].temperature ||
+            lhs[i].solar_rad != rhs[i].solar_rad)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
@@ -0,0 +1,236 @@
+#include "../FileIO.h"
+#include "../Sort.h"
+#include "../Calc.h"
+#include "../Utils.h"
+#include <chrono>
+#include <iostream>
+
+//---------------------------------------------------------------------------------------
+
+const char * const BENCH_NAME = "Metdata-Jan-Dec2007.csv";
+const int REPETITIONS = 5;
+const int DECADE_YEARS = 10;
+
+//---------------------------------------------------------------------------------------
+
+/// A record wrapper that orders records the way AtmosRecType did before the packed timestamp existed,
+/// by walking the Date and MyTime getters.
+typedef struct {
+    AtmosRecType rec; /// The wrapped record.
+} LegacyRecType;
+
+bool operator <(const LegacyRecType & lhs, const LegacyRecType & rhs);
+
+bool operator >(const LegacyRecType & lhs, const LegacyRecType & rhs);
+
+template <class T>
+double TimeSort(const Vector<T> & input, Vector<T> & result, void (*sort)(Vector<T> &, int, int));
+
+void Shuffle(AtmosLogType & data);
+
+void BuildDecade(const AtmosLogType & year, AtmosLogType & decade);
+
+//---------------------------------------------------------------------------------------
+
+int main()
+{
+    std::cout << "Sort Benchmark\n";
+
+    AtmosLogType year;
+    if (LoadMappedFile(BENCH_NAME, year) != LOAD_OK)
+    {
+        std::cout << "Unable to load " << BENCH_NAME << std::endl;
+        return 1;
+    }
+    std::cout << "Records: " << year.GetSize() << ", best of " << REPETITIONS << " runs\n\n";
+
+    // The CSV files arrive in time order, which the merge sort should detect
+    AtmosLogType fileOrderSorted;
+    double fileOrderMs = TimeSort(year, fileOrderSorted, MergeSort<AtmosRecType>);
+    std::cout << "MergeSort, file order (already sorted): " << fileOrderMs << " ms\n";
+
+    // The radix sort is stable, so on time-ordered input it must leave every record where it was
+    AtmosLogType fileOrderRadix;
+    double fileOrderRadixMs = TimeSort(year, fileOrderRadix, RadixSortByTimestamp<AtmosRecType>);
+    std::cout << "RadixSortByTimestamp, file order:       " << fileOrderRadixMs << " ms\n";
+    for (int i = 0; i < year.GetSize(); i++)
+    {
+        if (fileOrderRadix[i].timestamp != year[i].timestamp || fileOrderRadix[i].speed != year[i].speed ||
+            fileOrderRadix[i].temperature != year[i].temperature || fileOrderRadix[i].solar_rad != year[i].solar_rad)
+        {
+            std::cout << "RadixSortByTimestamp moved record " << i << " of sorted input" << std::endl;
+            return 1;
+        }
+    }
+
+    Shuffle(year);
+
+    Vector<LegacyRecType> legacyYear;
+    for (int i = 0; i < year.GetSize(); i++)
+    {
+        LegacyRecType wrapped;
+        wrapped.rec = year[i];
+        legacyYear.PushBack(wrapped);
+    }
+
+    AtmosLogType keySorted;
+    Vector<LegacyRecType> legacySorted;
+    double legacyMs = TimeSort(legacyYear, legacySorted, MergeSort<LegacyRecType>);
+    double keyMs = TimeSort(year, keySorted, MergeSort<AtmosRecType>);
+    AtmosLogType radixSorted;
+    double radixMs = TimeSort(year, radixSorted, RadixSortByTimestamp<AtmosRecType>);
+
+    std::cout << "MergeSort, shuffled, Date + MyTime comparisons: " << legacyMs << " ms\n";
+    std::cout << "MergeSort, shuffled, packed timestamp key:      " << keyMs << " ms\n";
+    if (keyMs > 0)
+    {
+        std::cout << "Speedup: " << (legacyMs / keyMs) << "x\n";
+    }
+    std::cout << "RadixSortByTimestamp, shuffled:                 " << radixMs << " ms\n";
+    if (radixMs > 0)
+    {
+        std::cout << "Speedup over MergeSort with packed key: " << (keyMs / radixMs) << "x\n";
+    }
+
+    for (int i = 0; i < keySorted.GetSize(); i++)
+    {
+        if (keySorted[i].timestamp != legacySorted[i].rec.timestamp ||
+            keySorted[i].timestamp != fileOrderSorted[i].timestamp ||
+            keySorted[i].timestamp != radixSorted[i].timestamp)
+        {
+            std::cout << "MISMATCH at index " << i << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "All orderings agree\n\n";
+
+    // The same year repeated under ten year numbers stands in for a decade of 10-minute records
+    AtmosLogType decade;
+    BuildDecade(year, decade);
+    std::cout << "Decade records: " << decade.GetSize() << " (shuffled), workers: "
+              << GetWorkerCount(decade.GetSize() / PARALLEL_SORT_GRAIN) << "\n";
+
+    AtmosLogType serialSorted;
+    AtmosLogType parallelSorted;
+    double serialMs = TimeSort(decade, serialSorted, MergeSort<AtmosRecType>);
+    double parallelMs = TimeSort(decade, parallelSorted, ParallelMergeSort<AtmosRecType>);
+    AtmosLogType decadeRadix;
+    double decadeRadixMs = TimeSort(decade, decadeRadix, RadixSortByTimestamp<AtmosRecType>);
+
+    std::cout << "MergeSort:         " << serialMs << " ms\n";
+    std::cout << "ParallelMergeSort: " << parallelMs << " ms\n";
+    std::cout << "RadixSortByTimestamp: " << decadeRadixMs << " ms\n";
+    if (parallelMs > 0)
+    {
+        std::cout << "ParallelMergeSort speedup: " << (serialMs / parallelMs) << "x\n";
+    }
+    if (decadeRadixMs > 0)
+    {
+        std::cout << "RadixSortByTimestamp speedup: " << (serialMs / decadeRadixMs) << "x\n";
+    }
+
+    for (int i = 0; i < serialSorted.GetSize(); i++)
+    {
+        if (serialSorted[i].timestamp != parallelSorted[i].timestamp ||
+            !CompareFloats(serialSorted[i].speed, parallelSorted[i].speed) ||
+            serialSorted[i].timestamp != decadeRadix[i].timestamp)
+        {
+            std::cout << "MISMATCH at index " << i << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "All sorts agree\n";
+
+    return 0;
+}
+
+//---------------------------------------------------------------------------------------
+
+bool operator <(const LegacyRecType & lhs, const LegacyRecType & rhs)
+{
+    if (!(lhs.rec.date == rhs.rec.date))
+    {
+        return lhs.rec.date < rhs.rec.date;
+    }
+    if (!(lhs.rec.time == rhs.rec.time))
+    {
+        return lhs.rec.time < rhs.rec.time;
+    }
+    if (!CompareFloats(lhs.rec.speed, rhs.rec.speed))
+    {
+        return lhs.rec.speed < rhs.rec.speed;
+    }
+    if (!CompareFloats(lhs.rec.temperature, rhs.rec.temperature))
+    {
+        return lhs.rec.temperature < rhs.rec.temperature;
+    }
+    if (!CompareFloats(lhs.rec.solar_rad, rhs.rec.solar_rad))
+    {
+        return lhs.rec.solar_rad < rhs.rec.solar_rad;
+    }
+    return false;
+}
+
+//---------------------------------------------------------------------------------------
+
+bool operator >(const LegacyRecType & lhs, const LegacyRecType & rhs)
+{
+    return rhs < lhs;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+double TimeSort(const Vector<T> & input, Vector<T> & result, void (*sort)(Vector<T> &, int, int))
+{
+    double best = -1;
+    for (int run = 0; run < REPETITIONS; run++)
+    {
+        Vector<T> data = input;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        sort(data, 0, data.GetSize() - 1);
+
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        if (best < 0 || elapsed.count() < best)
+        {
+            best = elapsed.count();
+        }
+        result = data;
+    }
+    return best;
+}
+
+//---------------------------------------------------------------------------------------
+
+void Shuffle(AtmosLogType & data)
+{
+    // Fixed-seed linear congruential generator, so every run sorts the same permutation
+    unsigned int seed = 12345;
+    for (int i = data.GetSize() - 1; i > 0; i--)
+    {
+        seed = seed * 1103515245u + 12345u;
+        int j = (seed >> 8) % (i + 1);
+        Swap(data[i], data[j]);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+
+void BuildDecade(const AtmosLogType & year, AtmosLogType & decade)
+{
+    decade.Reserve(year.GetSize() * DECADE_YEARS);
+    for (int y = 0; y < DECADE_YEARS; y++)
+    {
+        for (int i = 0; i < year.GetSize(); i++)
+        {
+            AtmosRecType rec = year[i];
+            rec.date.SetYear(rec.date.GetYear() - DECADE_YEARS + 1 + y);
+            rec.timestamp = MakeTimestamp(rec.date, rec.time);
+            decade.PushBack(rec);
+        }
+    }
+    Shuffle(decade);
+}
+
+//---------------------------------------------------------------------------------------
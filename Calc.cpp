@@ -12,7 +12,189 @@ bool CompareFloats(float a, float b)
 
 //----------------------------------------------------------------------------------
 
+float CalculateMean(const Vector<float> & vec, int total, SummationPolicy policy)
+{
+    return static_cast<float>(GetBestFloatKernels(policy).sum(vec.GetData(), total) / total);
+}
 
+//----------------------------------------------------------------------------------
 
+float CalculateStandardDeviation(const Vector<float> & vec, int N, float mean, SummationPolicy policy)
+{
+    return static_cast<float>(sqrt(GetBestFloatKernels(policy).sumSquaredDiff(vec.GetData(), N, mean) / (N - 1)));
+}
 
+//----------------------------------------------------------------------------------
+
+float CalculateTotal(const Vector<float> & vec, int size, SummationPolicy policy)
+{
+    return static_cast<float>(GetBestFloatKernels(policy).sum(vec.GetData(), size));
+}
+
+//----------------------------------------------------------------------------------
+
+float CalculateCovariance(const Vector<float>& x, const Vector<float>& y, float meanX, float meanY,
+                          SummationPolicy policy)
+{
+    const FloatKernels & kernels = GetBestFloatKernels(policy);
+    return static_cast<float>(kernels.sumCrossDiff(x.GetData(), y.GetData(), x.GetSize(), meanX, meanY));
+}
+
+//----------------------------------------------------------------------------------
+
+float CalculateVariance(const Vector<float>& vec, float mean, SummationPolicy policy)
+{
+    return static_cast<float>(GetBestFloatKernels(policy).sumSquaredDiff(vec.GetData(), vec.GetSize(), mean));
+}
+
+//----------------------------------------------------------------------------------
 
+float MAD(const Vector<float> & vec, int size, SummationPolicy policy)
+{
+    const FloatKernels & kernels = GetBestFloatKernels(policy);
+    float mean = static_cast<float>(kernels.sum(vec.GetData(), size) / size);
+    return static_cast<float>(kernels.sumAbsDiff(vec.GetData(), size, mean) / size);
+}
+
+//----------------------------------------------------------------------------------
+
+ColumnStats CalculateColumnStats(const Vector<float> & vec, int begin, int end, float skip, SummationPolicy policy)
+{
+    const FloatKernels & kernels = GetBestFloatKernels(policy);
+    const float * x = vec.GetData() + begin;
+    ColumnStatsAccumulator acc;
+    ResetColumnStats(acc);
+
+    acc.sum = kernels.sumSkipping(x, end - begin, skip, &acc.count);
+    FinishMeanPass(acc);
+    acc.squaredDiffs = kernels.sumSquaredAbsDiffSkipping(x, end - begin, acc.mean, skip, &acc.absDiffs);
+    return GetColumnStats(acc);
+}
+
+//----------------------------------------------------------------------------------
+
+void ResetColumnStats(ColumnStatsAccumulator & acc)
+{
+    acc.count = 0;
+    acc.sum = 0;
+    acc.mean = 0;
+    acc.squaredDiffs = 0;
+    acc.absDiffs = 0;
+}
+
+//----------------------------------------------------------------------------------
+
+void AddToMeanPass(ColumnStatsAccumulator & acc, float value)
+{
+    acc.count++;
+    acc.sum += value;
+}
+
+//----------------------------------------------------------------------------------
+
+void FinishMeanPass(ColumnStatsAccumulator & acc)
+{
+    acc.mean = acc.count > 0 ? static_cast<float>(acc.sum / acc.count) : 0;
+}
+
+//----------------------------------------------------------------------------------
+
+void AddToDeviationPass(ColumnStatsAccumulator & acc, float value)
+{
+    // The difference is taken in float, as the kernels do
+    double diff = value - acc.mean;
+    acc.squaredDiffs += diff * diff;
+    acc.absDiffs += std::fabs(diff);
+}
+
+//----------------------------------------------------------------------------------
+
+ColumnStats GetColumnStats(const ColumnStatsAccumulator & acc)
+{
+    ColumnStats stats = {acc.count, acc.mean, 0, 0};
+    if (acc.count > 1)
+    {
+        stats.stddev = static_cast<float>(sqrt(acc.squaredDiffs / (acc.count - 1)));
+    }
+    if (acc.count > 0)
+    {
+        stats.mad = static_cast<float>(acc.absDiffs / acc.count);
+    }
+    return stats;
+}
+
+//----------------------------------------------------------------------------------
+
+void ResetPearson(PearsonAccumulator & acc)
+{
+    acc.n = 0;
+    acc.meanX = 0;
+    acc.meanY = 0;
+    acc.m2X = 0;
+    acc.m2Y = 0;
+    acc.cXY = 0;
+}
+
+//----------------------------------------------------------------------------------
+
+void AddPearsonPair(PearsonAccumulator & acc, double x, double y)
+{
+    acc.n++;
+    double dx = x - acc.meanX;
+    double dy = y - acc.meanY;
+    acc.meanX += dx / acc.n;
+    acc.meanY += dy / acc.n;
+
+    // The second factor uses the updated mean, which keeps the co-moments exact
+    acc.m2X += dx * (x - acc.meanX);
+    acc.m2Y += dy * (y - acc.meanY);
+    acc.cXY += dx * (y - acc.meanY);
+}
+
+//----------------------------------------------------------------------------------
+
+void MergePearson(PearsonAccumulator & acc, const PearsonAccumulator & other)
+{
+    if (other.n == 0)
+    {
+        return;
+    }
+    if (acc.n == 0)
+    {
+        acc = other;
+        return;
+    }
+
+    double n = acc.n + other.n;
+    double dx = other.meanX - acc.meanX;
+    double dy = other.meanY - acc.meanY;
+    double weight = static_cast<double>(acc.n) * other.n / n;
+
+    acc.m2X += other.m2X + dx * dx * weight;
+    acc.m2Y += other.m2Y + dy * dy * weight;
+    acc.cXY += other.cXY + dx * dy * weight;
+    acc.meanX += dx * other.n / n;
+    acc.meanY += dy * other.n / n;
+    acc.n += other.n;
+}
+
+//----------------------------------------------------------------------------------
+
+float PearsonCoefficient(const PearsonAccumulator & acc)
+{
+    if (acc.n == 0)
+    {
+        std::cout << "Vectors are empty.\n";
+        return -1;
+    }
+
+    double denom = sqrt(acc.m2X) * sqrt(acc.m2Y);
+    if (denom == 0)
+    {
+        return 0;
+    }
+
+    return static_cast<float>(acc.cXY / denom);
+}
+
+//----------------------------------------------------------------------------------
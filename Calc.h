@@ -4,6 +4,7 @@
 //----------------------------------------------------------------------------------
 
 #include "vector.h"
+#include "FloatKernels.h"
 #include <math.h>
 #include <iostream>
 
@@ -33,6 +34,20 @@ T CalculateMean(const Vector<T> & vec, int total)
     return sum/total;
 }
 
+    /**
+    * @brief Calculates the mean of a vector of floats with the fastest vectorized kernel the processor supports.
+    *
+    * Overloads the template for float, summing in double precision with GetBestFloatKernels().sum.
+    *
+    * @param vec - A vector of floats.
+    * @param total - The number of elements to include in the mean calculation.
+    * @param policy - How the terms are summed, see SummationPolicy.
+    * @return The mean of the first total elements.
+    * @pre 0 < total <= vec.GetSize().
+    * @post Returns the calculated mean.
+    */
+float CalculateMean(const Vector<float> & vec, int total, SummationPolicy policy = DEFAULT_SUMMATION);
+
 //----------------------------------------------------------------------------------
 
     /**
@@ -61,6 +76,23 @@ float CalculateStandardDeviation(const Vector<T> & vec, int N, float mean)
     return sqrt(sum / (N - 1));
 }
 
+    /**
+    * @brief Calculates the sample standard deviation of a vector of floats with a vectorized kernel.
+    *
+    * Overloads the template for float, summing the squared differences in double precision with
+    * GetBestFloatKernels().sumSquaredDiff.
+    *
+    * @param vec - A vector of floats.
+    * @param N - The number of elements to include in the standard deviation calculation.
+    * @param mean - The precalculated mean of the elements.
+    * @param policy - How the terms are summed, see SummationPolicy.
+    * @return The sample standard deviation of the first N elements.
+    * @pre 1 < N <= vec.GetSize().
+    * @post Returns the sample standard deviation.
+    */
+float CalculateStandardDeviation(const Vector<float> & vec, int N, float mean,
+                                 SummationPolicy policy = DEFAULT_SUMMATION);
+
 //----------------------------------------------------------------------------------
 
     /**
@@ -86,6 +118,21 @@ T CalculateTotal(const Vector<T> & vec, int size)
     return sum;
 }
 
+    /**
+    * @brief Calculates the total of a vector of floats with a vectorized kernel.
+    *
+    * Overloads the template for float, summing in double precision with GetBestFloatKernels().sum, so a long
+    * column such as a year of solar radiation readings does not drift the way a float running total does.
+    *
+    * @param vec - A vector of floats.
+    * @param size - The number of elements to include in the summation.
+    * @param policy - How the terms are summed, see SummationPolicy.
+    * @return The total of the first size elements.
+    * @pre 0 <= size <= vec.GetSize().
+    * @post Returns the total.
+    */
+float CalculateTotal(const Vector<float> & vec, int size, SummationPolicy policy = DEFAULT_SUMMATION);
+
 //----------------------------------------------------------------------------------
 
     /**
@@ -175,6 +222,21 @@ float CalculateCovariance(const Vector<T>& x, const Vector<T>& y, float meanX, f
     return sumXY;
 }
 
+    /**
+    * @brief Computes the covariance component for sPCC between two vectors of floats with a vectorized kernel.
+    *
+    * Overloads the template for float, using GetBestFloatKernels().sumCrossDiff.
+    *
+    * @param x The first data vector.
+    * @param y The second data vector, at least as long as x.
+    * @param meanX The precomputed mean of vector x.
+    * @param meanY The precomputed mean of vector y.
+    * @param policy How the terms are summed, see SummationPolicy.
+    * @return The sum of products of differences from the means.
+    */
+float CalculateCovariance(const Vector<float>& x, const Vector<float>& y, float meanX, float meanY,
+                          SummationPolicy policy = DEFAULT_SUMMATION);
+
 //----------------------------------------------------------------------------------
 
     /**
@@ -197,6 +259,18 @@ float CalculateVariance(const Vector<T>& vec, float mean) {
     return sumSquaredDiff;
 }
 
+    /**
+    * @brief Calculates the sum of squared differences of a vector of floats with a vectorized kernel.
+    *
+    * Overloads the template for float, using GetBestFloatKernels().sumSquaredDiff.
+    *
+    * @param vec The data vector.
+    * @param mean The mean of the vector's values.
+    * @param policy How the terms are summed, see SummationPolicy.
+    * @return The sum of squared differences from the mean.
+    */
+float CalculateVariance(const Vector<float>& vec, float mean, SummationPolicy policy = DEFAULT_SUMMATION);
+
 //----------------------------------------------------------------------------------
 
     /**
@@ -225,6 +299,183 @@ float MAD(const Vector<T> & vec, int size)
     return sum / size;
 }
 
+    /**
+    * @brief Calculates the Mean Absolute Deviation (MAD) of a vector of floats with vectorized kernels.
+    *
+    * Overloads the template for float, using GetBestFloatKernels().sum for the mean and sumAbsDiff for the
+    * deviations.
+    *
+    * @param vec - A vector of floats.
+    * @param size - The number of elements to include in the MAD calculation.
+    * @param policy - How the terms are summed, see SummationPolicy.
+    * @return The mean absolute deviation of the first size elements.
+    * @pre 0 < size <= vec.GetSize().
+    * @post Returns the mean absolute deviation.
+    */
+float MAD(const Vector<float> & vec, int size, SummationPolicy policy = DEFAULT_SUMMATION);
+
+//----------------------------------------------------------------------------------
+
+/// The statistics of the valid values of a column, as computed by CalculateColumnStats().
+typedef struct {
+    int count; /// Number of valid values.
+    float mean; /// Mean of the valid values, 0 if there are none.
+    float stddev; /// Sample standard deviation of the valid values, 0 if there are fewer than two.
+    float mad; /// Mean absolute deviation of the valid values from their mean, 0 if there are none.
+} ColumnStats;
+
+/// The sums of the two passes of the fused statistics, for values that arrive one at a time.
+///
+/// The first pass adds every value with AddToMeanPass(), and FinishMeanPass() fixes the mean. The second pass adds
+/// the same values again with AddToDeviationPass(), which sums both the squared and the absolute differences from
+/// that mean. The values are never stored, so a range query can feed them straight from the records it visits.
+typedef struct {
+    int count; /// Number of values added in the first pass.
+    double sum; /// Sum of the values added in the first pass.
+    float mean; /// The mean of the first pass, set by FinishMeanPass().
+    double squaredDiffs; /// Sum of the squared differences from mean of the second pass.
+    double absDiffs; /// Sum of the absolute differences from mean of the second pass.
+} ColumnStatsAccumulator;
+
+//----------------------------------------------------------------------------------
+
+    /**
+    * @brief Calculates the mean, sample standard deviation and MAD of the valid values in a range of a vector.
+    *
+    * The first pass counts and sums the values that are not equal to skip, which gives the mean. The second pass
+    * sums both the squared and the absolute differences from that mean with one kernel, so each value is read
+    * twice, where calling CalculateMean, CalculateStandardDeviation and MAD reads it four times.
+    *
+    * @param vec - A vector of floats.
+    * @param begin - The index of the first value of the range.
+    * @param end - The index one past the last value of the range.
+    * @param skip - The value that marks a missing reading, such as -1.0f.
+    * @param policy - How the terms are summed, see SummationPolicy.
+    * @return The statistics of the values in [begin, end) that are not equal to skip.
+    * @pre 0 <= begin <= end <= vec.GetSize().
+    * @post None.
+    */
+ColumnStats CalculateColumnStats(const Vector<float> & vec, int begin, int end, float skip,
+                                 SummationPolicy policy = DEFAULT_SUMMATION);
+
+    /**
+    * @brief Resets an accumulator to hold no values.
+    *
+    * @param acc - The accumulator to reset.
+    * @return void
+    * @pre None.
+    * @post acc.count is 0 and all sums are 0.
+    */
+void ResetColumnStats(ColumnStatsAccumulator & acc);
+
+    /**
+    * @brief Adds a value to the first pass of an accumulator.
+    *
+    * @param acc - The accumulator to update.
+    * @param value - The valid value to add.
+    * @return void
+    * @pre acc has been reset and FinishMeanPass() has not been called.
+    * @post count and sum include value.
+    */
+void AddToMeanPass(ColumnStatsAccumulator & acc, float value);
+
+    /**
+    * @brief Ends the first pass of an accumulator and fixes the mean the second pass measures from.
+    *
+    * @param acc - The accumulator to update.
+    * @return void
+    * @pre Every value has been added with AddToMeanPass().
+    * @post acc.mean is the mean of the values, or 0 if there are none.
+    */
+void FinishMeanPass(ColumnStatsAccumulator & acc);
+
+    /**
+    * @brief Adds a value to the second pass of an accumulator.
+    *
+    * @param acc - The accumulator to update.
+    * @param value - A value that was added in the first pass.
+    * @return void
+    * @pre FinishMeanPass() has been called.
+    * @post squaredDiffs and absDiffs include the differences of value from mean.
+    */
+void AddToDeviationPass(ColumnStatsAccumulator & acc, float value);
+
+    /**
+    * @brief Returns the statistics of the values of both passes of an accumulator.
+    *
+    * @param acc - The accumulator holding the values.
+    * @return The count, mean, sample standard deviation and MAD of the values.
+    * @pre Every value of the first pass has also been added with AddToDeviationPass().
+    * @post No modification to acc.
+    */
+ColumnStats GetColumnStats(const ColumnStatsAccumulator & acc);
+
+//----------------------------------------------------------------------------------
+
+/// Running sums of a stream of (x, y) pairs, from which the Sample Pearson Correlation Coefficient follows.
+///
+/// The means and co-moments are updated with Welford's method as each pair arrives, so the pairs never need to
+/// be stored and the sums do not lose precision the way the naive sum-of-squares formula does.
+typedef struct {
+    int n; /// Number of pairs added.
+    double meanX; /// Mean of the x values.
+    double meanY; /// Mean of the y values.
+    double m2X; /// Sum of squared differences of x from its mean.
+    double m2Y; /// Sum of squared differences of y from its mean.
+    double cXY; /// Sum of products of the differences of x and y from their means.
+} PearsonAccumulator;
+
+//----------------------------------------------------------------------------------
+
+    /**
+    * @brief Resets an accumulator to hold no pairs.
+    *
+    * @param acc - The accumulator to reset.
+    * @return void
+    * @pre None.
+    * @post acc.n is 0 and all sums are 0.
+    */
+void ResetPearson(PearsonAccumulator & acc);
+
+    /**
+    * @brief Adds one (x, y) pair to an accumulator.
+    *
+    * @param acc - The accumulator to update.
+    * @param x - The x value of the pair.
+    * @param y - The y value of the pair.
+    * @return void
+    * @pre acc has been reset.
+    * @post acc describes all pairs added so far, including (x, y).
+    */
+void AddPearsonPair(PearsonAccumulator & acc, double x, double y);
+
+    /**
+    * @brief Merges the pairs of one accumulator into another.
+    *
+    * Uses the pairwise update of Chan et al., so pairs can be accumulated in separate parts (for example on
+    * different threads) and combined afterwards.
+    *
+    * @param acc - The accumulator to update.
+    * @param other - The accumulator whose pairs are added to acc.
+    * @return void
+    * @pre Both accumulators have been reset before use.
+    * @post acc describes the pairs of both accumulators. other is unchanged.
+    */
+void MergePearson(PearsonAccumulator & acc, const PearsonAccumulator & other);
+
+    /**
+    * @brief Calculates the Sample Pearson Correlation Coefficient (sPCC) of the accumulated pairs.
+    *
+    * Gives the same result as sPCC() over vectors holding the same pairs.
+    *
+    * @param acc - The accumulator holding the pairs.
+    * @return The correlation coefficient between -1.0 and 1.0, 0 if either variable is constant, or -1 if no pairs
+    * were added.
+    * @pre acc has been reset before use.
+    * @post No modification to acc.
+    */
+float PearsonCoefficient(const PearsonAccumulator & acc);
+
 //----------------------------------------------------------------------------------
 
     /**
@@ -0,0 +1,544 @@
+#include "../calc.h"
+#include "../FloatKernels.h"
+#include "../AtmosphereLogTypes.h"
+#include <cfloat>
+#include <cmath>
+#include <iostream>
+
+//---------------------------------------------------------------------------------------
+
+const int LONG_COLUMN = 1 << 24;
+const SummationPolicy POLICIES[] = {SUMMATION_DOUBLE, SUMMATION_NEUMAIER, SUMMATION_PAIRWISE};
+const int POLICY_COUNT = 3;
+
+/// The relative error the compensated and pairwise policies must stay within on every column. Only the plain double
+/// sums inside one block can lose bits, so the bound depends on SUMMATION_BLOCK and not on the length of the column.
+const double STABLE_TOLERANCE = SUMMATION_BLOCK * DBL_EPSILON;
+
+//---------------------------------------------------------------------------------------
+
+/// A running sum in double-double arithmetic, about 106 bits, used as the high-precision reference.
+typedef struct {
+    double hi; /// The leading part of the sum.
+    double lo; /// The rounding error of hi, far below its last bit.
+} DoubleDoubleType;
+
+void TestOne();
+
+void TestTwo();
+
+void TestThree();
+
+void TestFour();
+
+void TestFive();
+
+void TestSix();
+
+void TestSeven();
+
+void TestEight();
+
+void TestNine();
+
+void TestTen();
+
+void TestEleven();
+
+void AddExact(DoubleDoubleType & sum, double value);
+
+void BuildColumn(Vector<float> & column, int size, float base, float range, unsigned int seed);
+
+double ReferenceSum(const Vector<float> & column);
+
+double ReferenceSumSquaredDiff(const Vector<float> & column, float c);
+
+double RelativeError(double value, double reference);
+
+bool ReportPolicies(const Vector<float> & column, double reference, bool squared, float c);
+
+//---------------------------------------------------------------------------------------
+
+int main()
+{
+    std::cout << "Calc Test\n";
+
+    std::cout << "Test One\n";
+    TestOne(); // Every level and policy returns 0 and a count of 0 for an empty column.
+    std::cout << std::endl;
+
+    std::cout << "Test Two\n";
+    TestTwo(); // Small columns of integers give exact results at every level and policy.
+    std::cout << std::endl;
+
+    std::cout << "Test Three\n";
+    TestThree(); // The float overloads give the textbook mean, standard deviation, MAD and covariance.
+    std::cout << std::endl;
+
+    std::cout << "Test Four\n";
+    TestFour(); // A long solar radiation like column: every policy is accurate, the float template drifts.
+    std::cout << std::endl;
+
+    std::cout << "Test Five\n";
+    TestFive(); // One huge reading followed by millions of small ones, which the double policy loses.
+    std::cout << std::endl;
+
+    std::cout << "Test Six\n";
+    TestSix(); // Sum of squared differences on a long column, as used for variance.
+    std::cout << std::endl;
+
+    std::cout << "Test Seven\n";
+    TestSeven(); // Skipped values are counted the same at every level and policy across block boundaries.
+    std::cout << std::endl;
+
+    std::cout << "Test Eight\n";
+    TestEight(); // CalculateColumnStats agrees with the separate mean, standard deviation and MAD calls.
+    std::cout << std::endl;
+
+    std::cout << "Test Nine\n";
+    TestNine(); // CalculateColumnStats on ranges with no valid values, one value, and an empty range.
+    std::cout << std::endl;
+
+    std::cout << "Test Ten\n";
+    TestTen(); // A ColumnStatsAccumulator fed one value at a time gives the same statistics as CalculateColumnStats.
+    std::cout << std::endl;
+
+    std::cout << "Test Eleven\n";
+    TestEleven(); // A FieldSummary gives the same mean and standard deviation as GetColumnStats, including one value.
+    std::cout << std::endl;
+
+    return 0;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestOne()
+{
+    bool zero = true;
+    for (int level = KERNEL_SCALAR; level <= KERNEL_AVX2; level++)
+    {
+        if (!IsKernelLevelSupported(static_cast<KernelLevel>(level)))
+        {
+            continue;
+        }
+        for (int p = 0; p < POLICY_COUNT; p++)
+        {
+            const FloatKernels & kernels = GetFloatKernels(static_cast<KernelLevel>(level), POLICIES[p]);
+            int count = -1;
+            zero = zero && kernels.sum(nullptr, 0) == 0 && kernels.sumSquaredDiff(nullptr, 0, 1.0f) == 0 &&
+                   kernels.sumCrossDiff(nullptr, nullptr, 0, 1.0f, 1.0f) == 0 &&
+                   kernels.sumAbsDiff(nullptr, 0, 1.0f) == 0;
+            double absSum = -1;
+            zero = zero && kernels.sumSkipping(nullptr, 0, -1.0f, &count) == 0 && count == 0 &&
+                   kernels.sumSquaredAbsDiffSkipping(nullptr, 0, 1.0f, -1.0f, &absSum) == 0 && absSum == 0;
+        }
+    }
+
+    Vector<float> empty;
+    std::cout << "CalculateTotal of an empty vector: " << CalculateTotal(empty, 0) << std::endl;
+    std::cout << "All kernels return 0 on an empty column: " << (zero ? "yes" : "no") << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestTwo()
+{
+    bool exact = true;
+    for (int size = 1; size <= 40; size++)
+    {
+        Vector<float> x;
+        Vector<float> y;
+        for (int i = 0; i < size; i++)
+        {
+            x.PushBack(static_cast<float>(i + 1));
+            y.PushBack(static_cast<float>(2 * size - i));
+        }
+        double n = size;
+        double sum = n * (n + 1) / 2;
+
+        for (int level = KERNEL_SCALAR; level <= KERNEL_AVX2; level++)
+        {
+            if (!IsKernelLevelSupported(static_cast<KernelLevel>(level)))
+            {
+                continue;
+            }
+            for (int p = 0; p < POLICY_COUNT; p++)
+            {
+                const FloatKernels & kernels = GetFloatKernels(static_cast<KernelLevel>(level), POLICIES[p]);
+                double squared = 0;
+                double cross = 0;
+                double absolute = 0;
+                for (int i = 0; i < size; i++)
+                {
+                    squared += (x[i] - 3.0) * (x[i] - 3.0);
+                    cross += (x[i] - 3.0) * (y[i] - 5.0);
+                    absolute += std::fabs(x[i] - 3.0);
+                }
+                exact = exact && kernels.sum(x.GetData(), size) == sum &&
+                        kernels.sumSquaredDiff(x.GetData(), size, 3.0f) == squared &&
+                        kernels.sumCrossDiff(x.GetData(), y.GetData(), size, 3.0f, 5.0f) == cross &&
+                        kernels.sumAbsDiff(x.GetData(), size, 3.0f) == absolute;
+            }
+        }
+    }
+    std::cout << "Exact for every size from 1 to 40: " << (exact ? "yes" : "no") << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestThree()
+{
+    Vector<float> x;
+    Vector<float> y;
+    float xs[] = {2, 4, 4, 4, 5, 5, 7, 9};
+    float ys[] = {1, 3, 2, 5, 4, 6, 8, 9};
+    for (int i = 0; i < 8; i++)
+    {
+        x.PushBack(xs[i]);
+        y.PushBack(ys[i]);
+    }
+
+    for (int p = 0; p < POLICY_COUNT; p++)
+    {
+        float mean = CalculateMean(x, x.GetSize(), POLICIES[p]);
+        std::cout << GetSummationPolicyName(POLICIES[p]) << ": mean " << mean << ", total "
+                  << CalculateTotal(x, x.GetSize(), POLICIES[p]) << ", sample standard deviation "
+                  << CalculateStandardDeviation(x, x.GetSize(), mean, POLICIES[p]) << ", MAD "
+                  << MAD(x, x.GetSize(), POLICIES[p]) << ", sum of squares "
+                  << CalculateVariance(x, mean, POLICIES[p]) << ", cross sum "
+                  << CalculateCovariance(x, y, mean, CalculateMean(y, y.GetSize(), POLICIES[p]), POLICIES[p])
+                  << std::endl;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestFour()
+{
+    // Readings between 0 and 1000 W/m2 over sixteen million ten-minute intervals, about three centuries
+    Vector<float> solar;
+    BuildColumn(solar, LONG_COLUMN, 0.0f, 1000.0f, 2007u);
+    double reference = ReferenceSum(solar);
+
+    float templateTotal = CalculateTotal<float>(solar, solar.GetSize());
+    std::cout << "CalculateTotal<float> relative error above 1e-4: "
+              << (RelativeError(templateTotal, reference) > 1e-4 ? "yes" : "no") << std::endl;
+
+    bool stable = ReportPolicies(solar, reference, false, 0.0f);
+    std::cout << "Compensated and pairwise within " << STABLE_TOLERANCE << ": " << (stable ? "yes" : "no")
+              << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestFive()
+{
+    // A faulty first reading of 1e16, then readings of 1, half the spacing of doubles near 1e16
+    Vector<float> column;
+    column.PushBack(1e16f);
+    for (int i = 1; i < LONG_COLUMN; i++)
+    {
+        column.PushBack(1.0f);
+    }
+    double reference = ReferenceSum(column);
+
+    const FloatKernels & plain = GetBestFloatKernels(SUMMATION_DOUBLE);
+    std::cout << "double policy loses the small readings: "
+              << (RelativeError(plain.sum(column.GetData(), column.GetSize()), reference) > STABLE_TOLERANCE ? "yes"
+                                                                                                            : "no")
+              << std::endl;
+
+    bool stable = ReportPolicies(column, reference, false, 0.0f);
+    std::cout << "Compensated and pairwise within " << STABLE_TOLERANCE << ": " << (stable ? "yes" : "no")
+              << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestSix()
+{
+    // Temperatures around 15 degrees, whose squared differences are small next to their running sum
+    Vector<float> temperature;
+    BuildColumn(temperature, LONG_COLUMN, -5.0f, 40.0f, 1999u);
+    float mean = CalculateMean(temperature, temperature.GetSize());
+    double reference = ReferenceSumSquaredDiff(temperature, mean);
+
+    bool stable = ReportPolicies(temperature, reference, true, mean);
+    std::cout << "Compensated and pairwise within " << STABLE_TOLERANCE << ": " << (stable ? "yes" : "no")
+              << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestSeven()
+{
+    bool same = true;
+    int sizes[] = {1, SUMMATION_BLOCK - 1, SUMMATION_BLOCK, SUMMATION_BLOCK + 1, 3 * SUMMATION_BLOCK + 5,
+                   7 * SUMMATION_BLOCK};
+    for (int s = 0; s < 6; s++)
+    {
+        Vector<float> column;
+        int expected = 0;
+        for (int i = 0; i < sizes[s]; i++)
+        {
+            bool missing = i % 7 == 3;
+            column.PushBack(missing ? -1.0f : static_cast<float>(i % 11));
+            expected += missing ? 0 : 1;
+        }
+
+        for (int level = KERNEL_SCALAR; level <= KERNEL_AVX2; level++)
+        {
+            if (!IsKernelLevelSupported(static_cast<KernelLevel>(level)))
+            {
+                continue;
+            }
+            for (int p = 0; p < POLICY_COUNT; p++)
+            {
+                const FloatKernels & kernels = GetFloatKernels(static_cast<KernelLevel>(level), POLICIES[p]);
+                int count = 0;
+                kernels.sumSkipping(column.GetData(), column.GetSize(), -1.0f, &count);
+                same = same && count == expected;
+            }
+        }
+    }
+    std::cout << "Counts match at every level, policy and block boundary: " << (same ? "yes" : "no") << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestEight()
+{
+    // Wind speeds with about one reading in seven missing, over sizes that end inside and on block boundaries
+    int sizes[] = {2, 9, SUMMATION_BLOCK + 3, 4463};
+    bool agree = true;
+    for (int s = 0; s < 4; s++)
+    {
+        Vector<float> column;
+        BuildColumn(column, sizes[s], 0.0f, 30.0f, 31u + s);
+        Vector<float> valid;
+        for (int i = 0; i < column.GetSize(); i++)
+        {
+            if (i % 7 == 3)
+            {
+                column[i] = -1.0f;
+            }
+            else
+            {
+                valid.PushBack(column[i]);
+            }
+        }
+
+        ColumnStats stats = CalculateColumnStats(column, 0, column.GetSize(), -1.0f);
+        float mean = CalculateMean(valid, valid.GetSize());
+        float stddev = CalculateStandardDeviation(valid, valid.GetSize(), mean);
+        float mad = MAD(valid, valid.GetSize());
+        std::cout << "Size " << sizes[s] << ": count " << stats.count << " of " << valid.GetSize() << std::endl;
+        agree = agree && stats.count == valid.GetSize() && RelativeError(stats.mean, mean) < 1e-6 &&
+                RelativeError(stats.stddev, stddev) < 1e-6 && RelativeError(stats.mad, mad) < 1e-6;
+    }
+    std::cout << "Fused statistics agree with the separate calls: " << (agree ? "yes" : "no") << std::endl;
+
+    Vector<float> month;
+    BuildColumn(month, 1000, -5.0f, 40.0f, 7u);
+    ColumnStats whole = CalculateColumnStats(month, 0, month.GetSize(), -1.0f);
+    ColumnStats part = CalculateColumnStats(month, 100, 200, -1.0f);
+    Vector<float> copy;
+    for (int i = 100; i < 200; i++)
+    {
+        copy.PushBack(month[i]);
+    }
+    std::cout << "Range [100, 200) count: " << part.count << ", mean matches a copy: "
+              << (RelativeError(part.mean, CalculateMean(copy, copy.GetSize())) < 1e-6 ? "yes" : "no")
+              << ", differs from the whole column: " << (part.mean != whole.mean ? "yes" : "no") << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestNine()
+{
+    Vector<float> column;
+    column.PushBack(-1.0f);
+    column.PushBack(-1.0f);
+    column.PushBack(12.5f);
+    column.PushBack(-1.0f);
+
+    ColumnStats missing = CalculateColumnStats(column, 0, 2, -1.0f);
+    std::cout << "All missing: count " << missing.count << ", mean " << missing.mean << ", stddev " << missing.stddev
+              << ", MAD " << missing.mad << std::endl;
+
+    ColumnStats single = CalculateColumnStats(column, 0, column.GetSize(), -1.0f);
+    std::cout << "One valid value: count " << single.count << ", mean " << single.mean << ", stddev " << single.stddev
+              << ", MAD " << single.mad << std::endl;
+
+    ColumnStats empty = CalculateColumnStats(column, 2, 2, -1.0f);
+    std::cout << "Empty range: count " << empty.count << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestTen()
+{
+    Vector<float> column;
+    BuildColumn(column, 10000, -5.0f, 40.0f, 99u);
+    for (int i = 0; i < column.GetSize(); i += 13)
+    {
+        column[i] = -1.0f;
+    }
+
+    ColumnStatsAccumulator acc;
+    ResetColumnStats(acc);
+    for (int i = 0; i < column.GetSize(); i++)
+    {
+        if (column[i] != -1.0f)
+        {
+            AddToMeanPass(acc, column[i]);
+        }
+    }
+    FinishMeanPass(acc);
+    for (int i = 0; i < column.GetSize(); i++)
+    {
+        if (column[i] != -1.0f)
+        {
+            AddToDeviationPass(acc, column[i]);
+        }
+    }
+
+    ColumnStats streamed = GetColumnStats(acc);
+    ColumnStats fused = CalculateColumnStats(column, 0, column.GetSize(), -1.0f);
+    std::cout << "Streamed count " << streamed.count << ", fused count " << fused.count << std::endl;
+    std::cout << "Streamed and fused statistics agree: "
+              << (streamed.count == fused.count && RelativeError(streamed.mean, fused.mean) < 1e-6 &&
+                  RelativeError(streamed.stddev, fused.stddev) < 1e-6 && RelativeError(streamed.mad, fused.mad) < 1e-6
+                      ? "yes"
+                      : "no")
+              << std::endl;
+
+    ColumnStatsAccumulator none;
+    ResetColumnStats(none);
+    FinishMeanPass(none);
+    std::cout << "No values: count " << GetColumnStats(none).count << ", mean " << GetColumnStats(none).mean
+              << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestEleven()
+{
+    Vector<float> column;
+    BuildColumn(column, 1000, -5.0f, 40.0f, 7u);
+
+    const int sizes[] = {1, 2, 1000};
+    for (int s = 0; s < 3; s++)
+    {
+        FieldSummary summary;
+        ResetSummary(summary);
+        ColumnStatsAccumulator acc;
+        ResetColumnStats(acc);
+        for (int i = 0; i < sizes[s]; i++)
+        {
+            AddToSummary(summary, column[i]);
+            AddToMeanPass(acc, column[i]);
+        }
+        FinishMeanPass(acc);
+        for (int i = 0; i < sizes[s]; i++)
+        {
+            AddToDeviationPass(acc, column[i]);
+        }
+
+        ColumnStats stats = GetColumnStats(acc);
+        float stddev = SummaryStandardDeviation(summary);
+        bool agree = RelativeError(SummaryMean(summary), stats.mean) < 1e-6 &&
+                     (stats.stddev == 0 ? stddev == 0 : RelativeError(stddev, stats.stddev) < 1e-4);
+        std::cout << sizes[s] << " values: summary stddev " << stddev << ", agrees with GetColumnStats: "
+                  << (agree ? "yes" : "no") << std::endl;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+
+void AddExact(DoubleDoubleType & sum, double value)
+{
+    // Knuth's two-sum gives the exact rounding error of hi + value
+    double hi = sum.hi + value;
+    double virtualValue = hi - sum.hi;
+    double error = (sum.hi - (hi - virtualValue)) + (value - virtualValue);
+    double lo = sum.lo + error;
+    sum.hi = hi + lo;
+    sum.lo = lo - (sum.hi - hi);
+}
+
+//---------------------------------------------------------------------------------------
+
+void BuildColumn(Vector<float> & column, int size, float base, float range, unsigned int seed)
+{
+    // Fixed-seed linear congruential generator, so every run tests the same column
+    column.Reserve(size);
+    for (int i = 0; i < size; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        column.PushBack(base + range * static_cast<float>((seed >> 8) & 0xffff) / 65535.0f);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+
+double ReferenceSum(const Vector<float> & column)
+{
+    DoubleDoubleType sum = {0, 0};
+    for (int i = 0; i < column.GetSize(); i++)
+    {
+        AddExact(sum, column[i]);
+    }
+    return sum.hi + sum.lo;
+}
+
+//---------------------------------------------------------------------------------------
+
+double ReferenceSumSquaredDiff(const Vector<float> & column, float c)
+{
+    // The kernels take the difference in float, and its square is exact in double
+    DoubleDoubleType sum = {0, 0};
+    for (int i = 0; i < column.GetSize(); i++)
+    {
+        double diff = column[i] - c;
+        AddExact(sum, diff * diff);
+    }
+    return sum.hi + sum.lo;
+}
+
+//---------------------------------------------------------------------------------------
+
+double RelativeError(double value, double reference)
+{
+    return std::fabs(value - reference) / std::fabs(reference);
+}
+
+//---------------------------------------------------------------------------------------
+
+bool ReportPolicies(const Vector<float> & column, double reference, bool squared, float c)
+{
+    bool stable = true;
+    for (int level = KERNEL_SCALAR; level <= KERNEL_AVX2; level++)
+    {
+        if (!IsKernelLevelSupported(static_cast<KernelLevel>(level)))
+        {
+            continue;
+        }
+        for (int p = 0; p < POLICY_COUNT; p++)
+        {
+            const FloatKernels & kernels = GetFloatKernels(static_cast<KernelLevel>(level), POLICIES[p]);
+            double value = squared ? kernels.sumSquaredDiff(column.GetData(), column.GetSize(), c)
+                                   : kernels.sum(column.GetData(), column.GetSize());
+            double error = RelativeError(value, reference);
+            std::cout << "  " << kernels.name << " " << GetSummationPolicyName(POLICIES[p]) << ": relative error "
+                      << error << std::endl;
+            if (POLICIES[p] != SUMMATION_DOUBLE)
+            {
+                stable = stable && error <= STABLE_TOLERANCE;
+            }
+        }
+    }
+    return stable;
+}
+
+//---------------------------------------------------------------------------------------
@@ -0,0 +1,536 @@
+#ifndef EYTZINGERINDEX_H
+#define EYTZINGERINDEX_H
+
+//---------------------------------------------------------------------------------------
+
+#include "BST.h"
+#include "Vector.h"
+#include "Visitor.h"
+
+//---------------------------------------------------------------------------------------
+
+#if defined(__GNUC__)
+/// Asks the processor to start loading the cache line holding address, without waiting for it.
+#define INDEX_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define INDEX_PREFETCH(address)
+#endif
+
+/// The number of bytes the processor loads into the cache at a time.
+const int INDEX_CACHE_LINE = 64;
+
+/// A search prefetches the descendants this many levels below the node it is comparing.
+const int INDEX_PREFETCH_LEVELS = 4;
+
+//---------------------------------------------------------------------------------------
+
+    /**
+    * @class EytzingerIndex
+    * @brief A read-only search index storing a sorted set of values in Eytzinger (breadth-first) order.
+    *
+    * The values are the nodes of a complete binary search tree laid out level by level in one array, with the
+    * root at index 1 and the children of index k at 2k and 2k + 1, so there are no node pointers to follow. The
+    * first levels of every search share the same few cache lines. The descendants of index k that are
+    * INDEX_PREFETCH_LEVELS levels down are adjacent (k * 16 to k * 16 + 15 for four levels), so they are prefetched while k is
+    * compared, and by the time the search reaches that level its node is already on its way into the cache. Each
+    * step of a search picks the next index with arithmetic instead of a branch.
+    *
+    * The index supports the same Search, InOrderTraversal, RangeQuery, VisitInOrder and VisitRange operations as
+    * BST, with the same results, but cannot be changed once built. Use it for data that is loaded once and only
+    * queried.
+    *
+    * @author agent
+    * @version 01
+    * @date 17/10/2026 agent, Started
+    *
+    * @author agent
+    * @version 02
+    * @date 17/10/2026 agent, Added VisitInOrder and VisitRange taking any callable, with early termination
+    *
+    * @todo Nothing
+    *
+    * @bug No bugs so far
+    */
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+class EytzingerIndex
+{
+public:
+    /**
+    * @brief Construct an empty EytzingerIndex object.
+    *
+    * @pre None.
+    * @post The index holds no values.
+    */
+    EytzingerIndex();
+
+    /**
+    * @brief Construct an EytzingerIndex object by copying another.
+    *
+    * @param other - The index to be copied.
+    * @pre other is a valid constructed EytzingerIndex object.
+    * @post The index holds the same values as other, in its own array.
+    */
+    EytzingerIndex(const EytzingerIndex<T> & other);
+
+    /**
+    * @brief Overloaded assignment operator for copying another index.
+    *
+    * @param other - The index to be copied.
+    * @return A reference to the assigned index.
+    * @pre other is a valid constructed EytzingerIndex object.
+    * @post The index holds the same values as other, and its previous array is freed.
+    */
+    EytzingerIndex<T> & operator=(const EytzingerIndex<T> & other);
+
+    /**
+    * @brief Destructor for the EytzingerIndex object.
+    *
+    * @pre None.
+    * @post The array is freed.
+    */
+    ~EytzingerIndex();
+
+    /**
+    * @brief Replace the contents of the index with the values of a sorted vector.
+    *
+    * Values equal to the one before them are skipped, as in BST::BuildFromSorted.
+    *
+    * @param sorted - The values to store, in ascending order.
+    * @return void
+    * @pre sorted is in ascending order.
+    * @post The index holds each distinct value of sorted once.
+    */
+    void Build(const Vector<T> & sorted);
+
+    /**
+    * @brief Replace the contents of the index with the values of a BST.
+    *
+    * @param tree - The tree whose values are stored.
+    * @return void
+    * @pre tree is a valid constructed BST object.
+    * @post The index holds every value of tree. tree is unchanged.
+    */
+    void Build(const BST<T> & tree);
+
+    /**
+    * @brief Return the number of values in the index.
+    *
+    * @return The number of values.
+    * @pre None.
+    * @post The index remains unchanged.
+    */
+    int GetSize() const;
+
+    /**
+    * @brief Search for a value in the index.
+    *
+    * @param val - The value to be searched for.
+    * @return true if the value exists, false if it doesn't.
+    * @pre T supports operator< and operator==.
+    * @post The index remains unchanged.
+    */
+    bool Search(const T & val) const;
+
+    /**
+    * @brief Perform in-order traversal using a function pointer callback.
+    *
+    * @param fp - A function pointer to a callback that accepts a reference to a value of type T.
+    * @return void
+    * @pre None.
+    * @post The callback function is called on each value in ascending order.
+    */
+    void InOrderTraversal(void (*fp)(const T &)) const;
+
+    /**
+    * @brief Perform in-order traversal using a function pointer callback that receives a context pointer.
+    *
+    * @param fp - A function pointer to a callback that accepts a reference to a value of type T and the context.
+    * @param context - A pointer passed unchanged to every call of fp.
+    * @return void
+    * @pre None.
+    * @post The callback function is called on each value in ascending order.
+    */
+    void InOrderTraversal(void (*fp)(const T &, void *), void * context) const;
+
+    /**
+    * @brief Visit, in ascending order, every value in the closed range [lo, hi].
+    *
+    * Finds the first value not less than lo with one search, then steps to each next value in order.
+    *
+    * @param lo - The smallest value to visit.
+    * @param hi - The largest value to visit.
+    * @param fp - A function pointer to a callback that accepts a reference to a value of type T.
+    * @return void
+    * @pre T supports operator< and operator>. If hi < lo, nothing is visited.
+    * @post The callback function is called on each value x with !(x < lo) and !(x > hi), in ascending order.
+    */
+    void RangeQuery(const T & lo, const T & hi, void (*fp)(const T &)) const;
+
+    /**
+    * @brief Visit, in ascending order, every value in the closed range [lo, hi], passing a context pointer.
+    *
+    * @param lo - The smallest value to visit.
+    * @param hi - The largest value to visit.
+    * @param fp - A function pointer to a callback that accepts a reference to a value of type T and the context.
+    * @param context - A pointer passed unchanged to every call of fp.
+    * @return void
+    * @pre T supports operator< and operator>. If hi < lo, nothing is visited.
+    * @post The callback function is called on each value x with !(x < lo) and !(x > hi), in ascending order.
+    */
+    void RangeQuery(const T & lo, const T & hi, void (*fp)(const T &, void *), void * context) const;
+
+    /**
+    * @brief Visit every value in ascending order with any callable.
+    *
+    * A visitor returning bool stops the traversal by returning true.
+    *
+    * @tparam Visitor The type of the callable, accepting a const T &.
+    * @param visitor - The callable to call on each value.
+    * @return true if the visitor stopped the traversal, false if every value was visited.
+    * @pre None.
+    * @post The visitor is called on each value in ascending order, up to and including the one that stopped it.
+    */
+    template <class Visitor>
+    bool VisitInOrder(Visitor && visitor) const;
+
+    /**
+    * @brief Visit, in ascending order, every value in the closed range [lo, hi] with any callable.
+    *
+    * A visitor returning bool stops the traversal before the end of the range by returning true.
+    *
+    * @tparam Visitor The type of the callable, accepting a const T &.
+    * @param lo - The smallest value to visit.
+    * @param hi - The largest value to visit.
+    * @param visitor - The callable to call on each value.
+    * @return true if the visitor stopped the traversal, false if every value in the range was visited.
+    * @pre T supports operator< and operator>. If hi < lo, nothing is visited.
+    * @post The visitor is called on each value x with !(x < lo) and !(x > hi), in ascending order, up to and
+    *       including the one that stopped it.
+    */
+    template <class Visitor>
+    bool VisitRange(const T & lo, const T & hi, Visitor && visitor) const;
+
+private:
+    T * m_data; /// The values in Eytzinger order, from index 1; index 0 is unused.
+    int m_size; /// The number of values.
+
+    /**
+    * @brief Return the index of the first value not less than val.
+    *
+    * @param val - The value to search for.
+    * @return The index of the smallest value x with !(x < val), or 0 if every value is less than val.
+    * @pre None.
+    * @post The index remains unchanged.
+    */
+    int LowerBound(const T & val) const;
+
+    /**
+    * @brief Return the index of the smallest value.
+    *
+    * @return The index of the leftmost value, or 0 if the index is empty.
+    * @pre None.
+    * @post The index remains unchanged.
+    */
+    int First() const;
+
+    /**
+    * @brief Return the index of the value that follows index k in ascending order.
+    *
+    * @param k - The index of a value.
+    * @return The index of the next value, or 0 if k holds the largest value.
+    * @pre 1 <= k <= m_size.
+    * @post The index remains unchanged.
+    */
+    int Next(int k) const;
+
+    /**
+    * @brief Store sorted values at their Eytzinger positions.
+    *
+    * Fills the subtree rooted at k by an in-order walk, taking the values from sorted in order.
+    *
+    * @param sorted - The values in ascending order.
+    * @param next - The index in sorted of the next value to place, advanced as values are placed.
+    * @param k - The root of the subtree to fill.
+    * @return void
+    * @pre sorted holds at least m_size values.
+    * @post The subtree at k holds the next values of sorted in in-order sequence.
+    */
+    void Place(const Vector<T> & sorted, int & next, int k);
+
+    /**
+    * @brief Free the array and empty the index.
+    *
+    * @return void
+    * @pre None.
+    * @post m_data is nullptr and m_size is 0.
+    */
+    void Clear();
+};
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+EytzingerIndex<T>::EytzingerIndex()
+{
+    m_data = nullptr;
+    m_size = 0;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+EytzingerIndex<T>::EytzingerIndex(const EytzingerIndex<T> & other)
+{
+    m_data = nullptr;
+    m_size = 0;
+    *this = other;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+EytzingerIndex<T> & EytzingerIndex<T>::operator=(const EytzingerIndex<T> & other)
+{
+    if (this != &other)
+    {
+        Clear();
+        if (other.m_size > 0)
+        {
+            m_data = new T[other.m_size + 1];
+            m_size = other.m_size;
+            for (int k = 1; k <= m_size; k++)
+            {
+                m_data[k] = other.m_data[k];
+            }
+        }
+    }
+    return *this;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+EytzingerIndex<T>::~EytzingerIndex()
+{
+    Clear();
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+void EytzingerIndex<T>::Build(const Vector<T> & sorted)
+{
+    Clear();
+
+    Vector<T> distinct;
+    distinct.Reserve(sorted.GetSize());
+    for (int i = 0; i < sorted.GetSize(); i++)
+    {
+        if (i == 0 || !(sorted[i] == sorted[i - 1]))
+        {
+            distinct.PushBack(sorted[i]);
+        }
+    }
+    if (distinct.GetSize() == 0)
+    {
+        return;
+    }
+
+    m_data = new T[distinct.GetSize() + 1];
+    m_size = distinct.GetSize();
+    int next = 0;
+    Place(distinct, next, 1);
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+void EytzingerIndex<T>::Build(const BST<T> & tree)
+{
+    Vector<T> sorted;
+    tree.VisitInOrder([&sorted](const T & val) { sorted.PushBack(val); });
+    Build(sorted);
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+int EytzingerIndex<T>::GetSize() const
+{
+    return m_size;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+bool EytzingerIndex<T>::Search(const T & val) const
+{
+    int k = LowerBound(val);
+    return k != 0 && m_data[k] == val;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+void EytzingerIndex<T>::InOrderTraversal(void (*fp)(const T &)) const
+{
+    VisitInOrder(fp);
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+void EytzingerIndex<T>::InOrderTraversal(void (*fp)(const T &, void *), void * context) const
+{
+    VisitInOrder([fp, context](const T & val) { fp(val, context); });
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+void EytzingerIndex<T>::RangeQuery(const T & lo, const T & hi, void (*fp)(const T &)) const
+{
+    VisitRange(lo, hi, fp);
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+void EytzingerIndex<T>::RangeQuery(const T & lo, const T & hi, void (*fp)(const T &, void *), void * context) const
+{
+    VisitRange(lo, hi, [fp, context](const T & val) { fp(val, context); });
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+template <class Visitor>
+bool EytzingerIndex<T>::VisitInOrder(Visitor && visitor) const
+{
+    for (int k = First(); k != 0; k = Next(k))
+    {
+        if (CallVisitor(visitor, m_data[k]))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+template <class Visitor>
+bool EytzingerIndex<T>::VisitRange(const T & lo, const T & hi, Visitor && visitor) const
+{
+    for (int k = LowerBound(lo); k != 0 && !(m_data[k] > hi); k = Next(k))
+    {
+        if (CallVisitor(visitor, m_data[k]))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+int EytzingerIndex<T>::LowerBound(const T & val) const
+{
+    const int descendants = 1 << INDEX_PREFETCH_LEVELS;
+    const int bytes = descendants * static_cast<int>(sizeof(T));
+
+    int k = 1;
+    while (k <= m_size)
+    {
+        if ((k + 1) * descendants - 1 <= m_size)
+        {
+            const char * first = reinterpret_cast<const char *>(&m_data[k * descendants]);
+            for (int offset = 0; offset < bytes; offset += INDEX_CACHE_LINE)
+            {
+                INDEX_PREFETCH(first + offset);
+            }
+        }
+        k = 2 * k + (m_data[k] < val ? 1 : 0);
+    }
+
+    // k went right after the answer every time since its last left turn; drop those right turns and the left turn
+    while (k & 1)
+    {
+        k >>= 1;
+    }
+    return k >> 1;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+int EytzingerIndex<T>::First() const
+{
+    if (m_size == 0)
+    {
+        return 0;
+    }
+
+    int k = 1;
+    while (2 * k <= m_size)
+    {
+        k = 2 * k;
+    }
+    return k;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+int EytzingerIndex<T>::Next(int k) const
+{
+    // The leftmost value of the right subtree, if there is one
+    if (2 * k + 1 <= m_size)
+    {
+        k = 2 * k + 1;
+        while (2 * k <= m_size)
+        {
+            k = 2 * k;
+        }
+        return k;
+    }
+
+    // Otherwise the first ancestor reached from its left subtree
+    while (k & 1)
+    {
+        k >>= 1;
+    }
+    return k >> 1;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+void EytzingerIndex<T>::Place(const Vector<T> & sorted, int & next, int k)
+{
+    if (k <= m_size)
+    {
+        Place(sorted, next, 2 * k);
+        m_data[k] = sorted[next++];
+        Place(sorted, next, 2 * k + 1);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+void EytzingerIndex<T>::Clear()
+{
+    delete[] m_data;
+    m_data = nullptr;
+    m_size = 0;
+}
+
+//---------------------------------------------------------------------------------------
+
+#endif // EYTZINGERINDEX_H
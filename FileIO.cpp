@@ -1,14 +1,27 @@
 #include "fileio.h"
 #include "atmospherelogtypes.h"
 #include "sort.h"
-#include "BST.h"
+#include "EytzingerIndex.h"
+#include "MappedFile.h"
+#include "Parallel.h"
+#include "AtmosCache.h"
 #include <map>
 #include <string>
 #include <iostream>
+#include <cstring>
+#include <cstdlib>
 
 //----------------------------------------------------------------------------------
 
-bool LoadAtmosphereData(AtmosLogType & atmosData)
+/// The smallest amount of row data worth handing to a separate thread in ParseAtmosphereBufferChunked().
+const int MIN_CHUNK_BYTES = 1 << 20;
+
+/// The binary snapshot written by LoadAtmosphereData() after parsing the CSV files.
+const char * const ATMOS_CACHE_PATH = "data/AtmosCache.bin";
+
+//----------------------------------------------------------------------------------
+
+bool LoadAtmosphereData(AtmosLogType & atmosData, IngestMode mode, bool useCache)
 {
     // Get input filenames from data_source.txt
     std::ifstream src("data/data_source.txt");
@@ -18,43 +31,163 @@ bool LoadAtmosphereData(AtmosLogType & atmosData)
         return false;
     }
 
-    // Collect data from input files
+    Vector<std::string> filenames;
     std::string inFilename;
     while (std::getline(src, inFilename))
     {
-        std::ifstream inFile("data/" + inFilename);
-        if (!inFile)
+        filenames.PushBack(inFilename);
+    }
+    src.close();
+
+    int fileCount = filenames.GetSize();
+    LoadStatus * fileStatus = new LoadStatus[fileCount];
+
+    if (!useCache || !LoadAtmosCache(ATMOS_CACHE_PATH, filenames, atmosData, fileStatus))
+    {
+        // Stamp the files before parsing them, so a change made while they are parsed invalidates the cache
+        Vector<FileStampType> fileStamps;
+        for (int i = 0; i < fileCount; i++)
         {
-            std::cout << "Unable to open input file " + inFilename << std::endl;
+            FileStampType stamp;
+            GetFileStamp("data/" + filenames[i], stamp);
+            fileStamps.PushBack(stamp);
+        }
+
+        // With fewer files than workers, parsing whole files side by side would leave workers idle, so each file
+        // is split across all of them instead. Files smaller than MIN_CHUNK_BYTES stay in one piece.
+        if (mode == INGEST_PARALLEL && fileCount < GetWorkerCount(1 << 30))
+        {
+            mode = INGEST_CHUNKED;
+        }
+
+        if (mode == INGEST_PARALLEL)
+        {
+            // Each worker fills the slot of the file it claimed, so no records are shared between threads
+            AtmosLogType * fileData = new AtmosLogType[fileCount];
+
+            ParallelFor(fileCount, [&](int i)
+            {
+                fileStatus[i] = LoadMappedFile(filenames[i], fileData[i]);
+            });
+
+            // Concatenate in data_source.txt order, so the result matches a sequential load
+            int total = atmosData.GetSize();
+            for (int i = 0; i < fileCount; i++)
+            {
+                total += fileData[i].GetSize();
+            }
+            atmosData.Reserve(total);
+            for (int i = 0; i < fileCount; i++)
+            {
+                for (int j = 0; j < fileData[i].GetSize(); j++)
+                {
+                    atmosData.PushBack(fileData[i][j]);
+                }
+            }
+            delete[] fileData;
         }
         else
         {
-            ReadAtmosphereData(inFile, atmosData);
-            inFile.close();
+            // Collect data from input files
+            for (int i = 0; i < fileCount; i++)
+            {
+                if (mode == INGEST_STREAM)
+                {
+                    fileStatus[i] = LoadStreamFile(filenames[i], atmosData);
+                }
+                else
+                {
+                    fileStatus[i] = LoadMappedFile(filenames[i], atmosData, mode == INGEST_CHUNKED);
+                }
+            }
+        }
+
+        if (useCache)
+        {
+            SaveAtmosCache(ATMOS_CACHE_PATH, filenames, fileStamps.GetData(), fileStatus, atmosData);
         }
     }
-    src.close();
+
+    // Problems are reported in data_source.txt order, whether the records came from the files or the cache
+    for (int i = 0; i < fileCount; i++)
+    {
+        ReportLoadStatus(fileStatus[i], filenames[i]);
+    }
+
+    delete[] fileStatus;
     return true;
 }
 
 //----------------------------------------------------------------------------------
 
-void ReadAtmosphereData(std::ifstream & file, AtmosLogType & atmosData)
+LoadStatus LoadStreamFile(const std::string & filename, AtmosLogType & atmosData)
+{
+    std::ifstream inFile("data/" + filename);
+    if (!inFile)
+    {
+        return LOAD_MISSING_FILE;
+    }
+
+    if (!ReadAtmosphereData(inFile, atmosData))
+    {
+        return LOAD_MISSING_COLUMNS;
+    }
+    return LOAD_OK;
+}
+
+//----------------------------------------------------------------------------------
+
+LoadStatus LoadMappedFile(const std::string & filename, AtmosLogType & atmosData, bool chunked)
+{
+    MappedFile inFile;
+    if (!inFile.Open("data/" + filename))
+    {
+        return LOAD_MISSING_FILE;
+    }
+
+    const char * begin = inFile.GetData();
+    const char * end = begin + inFile.GetSize();
+    bool parsed = chunked ? ParseAtmosphereBufferChunked(begin, end, atmosData)
+                          : ParseAtmosphereBuffer(begin, end, atmosData);
+    if (!parsed)
+    {
+        return LOAD_MISSING_COLUMNS;
+    }
+    return LOAD_OK;
+}
+
+//----------------------------------------------------------------------------------
+
+void ReportLoadStatus(LoadStatus status, const std::string & filename)
+{
+    if (status == LOAD_MISSING_FILE)
+    {
+        std::cout << "Unable to open input file " + filename << std::endl;
+    }
+    else if (status == LOAD_MISSING_COLUMNS)
+    {
+        std::cout << "Column missing in data file" << std::endl;
+    }
+}
+
+//----------------------------------------------------------------------------------
+
+bool ReadAtmosphereData(std::ifstream & file, AtmosLogType & atmosData)
 {
     std::string line;
     int wastIndex, sIndex, tIndex, srIndex;
 
     // Read entire header line and find column indices of WAST, S, T and SR
-    // If the columns don't exist, print error
-    if (!std::getline(file, line) || !GetColumnIndices(line, wastIndex, sIndex, tIndex, srIndex))
+    // If the columns don't exist, report it to the caller
+    if (!std::getline(file, line) || !GetColumnIndices(StripCarriageReturn(line), wastIndex, sIndex, tIndex, srIndex))
     {
-        std::cout << "Column missing in data file" << std::endl;
-        return;
+        return false;
     }
 
     // Using found column indices, parse and store data from each row
     while (std::getline(file, line))
     {
+        StripCarriageReturn(line);
         std::string wastData = "", sData = "", tData = "", srData = "";
         ReadRowData(line, wastData, wastIndex, sData, sIndex, tData, tIndex, srData, srIndex);
 
@@ -107,6 +240,7 @@ void ReadAtmosphereData(std::ifstream & file, AtmosLogType & atmosData)
             AtmosRecType a;
             a.date = dateTemp;
             a.time = timeTemp;
+            a.timestamp = MakeTimestamp(dateTemp, timeTemp);
             a.speed = speedTemp;
             a.temperature = temperatTemp;
             a.solar_rad = srTemp;
@@ -115,6 +249,155 @@ void ReadAtmosphereData(std::ifstream & file, AtmosLogType & atmosData)
             atmosData.PushBack(a);
         }
     }
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+
+std::string & StripCarriageReturn(std::string & line)
+{
+    if (!line.empty() && line[line.size() - 1] == '\r')
+    {
+        line.erase(line.size() - 1);
+    }
+    return line;
+}
+
+//----------------------------------------------------------------------------------
+
+bool ParseAtmosphereBuffer(const char * begin, const char * end, AtmosLogType & atmosData)
+{
+    const char * rowsBegin;
+    int wastIndex, sIndex, tIndex, srIndex;
+    if (!ParseBufferHeader(begin, end, rowsBegin, wastIndex, sIndex, tIndex, srIndex))
+    {
+        return false;
+    }
+
+    ParseAtmosphereRows(rowsBegin, end, wastIndex, sIndex, tIndex, srIndex, atmosData);
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+
+bool ParseAtmosphereBufferChunked(const char * begin, const char * end, AtmosLogType & atmosData)
+{
+    const char * rowsBegin;
+    int wastIndex, sIndex, tIndex, srIndex;
+    if (!ParseBufferHeader(begin, end, rowsBegin, wastIndex, sIndex, tIndex, srIndex))
+    {
+        return false;
+    }
+
+    long long rowBytes = end - rowsBegin;
+    int chunkCount = GetWorkerCount(static_cast<int>(rowBytes / MIN_CHUNK_BYTES));
+
+    // Chunk c covers [bounds[c], bounds[c + 1]); inner bounds are moved to the start of the next row
+    const char ** bounds = new const char *[chunkCount + 1];
+    bounds[0] = rowsBegin;
+    bounds[chunkCount] = end;
+    for (int c = 1; c < chunkCount; c++)
+    {
+        const char * split = rowsBegin + rowBytes * c / chunkCount;
+        if (split < bounds[c - 1])
+        {
+            split = bounds[c - 1];
+        }
+        const char * newline = static_cast<const char *>(std::memchr(split, '\n', end - split));
+        bounds[c] = (newline == nullptr) ? end : newline + 1;
+    }
+
+    AtmosLogType * chunkData = new AtmosLogType[chunkCount];
+    ParallelFor(chunkCount, [&](int c)
+    {
+        ParseAtmosphereRows(bounds[c], bounds[c + 1], wastIndex, sIndex, tIndex, srIndex, chunkData[c]);
+    });
+
+    int total = atmosData.GetSize();
+    for (int c = 0; c < chunkCount; c++)
+    {
+        total += chunkData[c].GetSize();
+    }
+    atmosData.Reserve(total);
+    for (int c = 0; c < chunkCount; c++)
+    {
+        for (int i = 0; i < chunkData[c].GetSize(); i++)
+        {
+            atmosData.PushBack(chunkData[c][i]);
+        }
+    }
+
+    delete[] chunkData;
+    delete[] bounds;
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+
+bool ParseBufferHeader(const char * begin, const char * end, const char * & rowsBegin,
+                       int & wastIndex, int & sIndex, int & tIndex, int & srIndex)
+{
+    // An empty buffer has no header line, same as a failed std::getline
+    if (begin == end)
+    {
+        return false;
+    }
+
+    const char * headerEnd = static_cast<const char *>(std::memchr(begin, '\n', end - begin));
+    if (headerEnd == nullptr)
+    {
+        headerEnd = end;
+    }
+
+    // The header is the only part of the file copied into a std::string, without the \r of a CRLF line end
+    const char * headerTextEnd = (headerEnd > begin && headerEnd[-1] == '\r') ? headerEnd - 1 : headerEnd;
+    std::string header(begin, headerTextEnd);
+    if (!GetColumnIndices(header, wastIndex, sIndex, tIndex, srIndex))
+    {
+        return false;
+    }
+
+    rowsBegin = (headerEnd < end) ? headerEnd + 1 : end;
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+
+void ParseAtmosphereRows(const char * begin, const char * end, int wastIndex, int sIndex, int tIndex, int srIndex,
+                         AtmosLogType & atmosData)
+{
+    const char * lineBegin = begin;
+    while (lineBegin < end)
+    {
+        const char * lineEnd = static_cast<const char *>(std::memchr(lineBegin, '\n', end - lineBegin));
+        if (lineEnd == nullptr)
+        {
+            lineEnd = end;
+        }
+
+        // Files written on Windows end each line with \r\n; the \r must not become part of the last field
+        const char * rowEnd = (lineEnd > lineBegin && lineEnd[-1] == '\r') ? lineEnd - 1 : lineEnd;
+
+        FieldView wastData, sData, tData, srData;
+        ReadRowFields(lineBegin, rowEnd, wastData, wastIndex, sData, sIndex, tData, tIndex, srData, srIndex);
+
+        Date dateTemp;
+        MyTime timeTemp;
+        if (wastData.begin != wastData.end && ParseDateTimeField(wastData, dateTemp, timeTemp))
+        {
+            AtmosRecType a;
+            a.date = dateTemp;
+            a.time = timeTemp;
+            a.timestamp = MakeTimestamp(dateTemp, timeTemp);
+            a.speed = ParseMeasurementField(sData);
+            a.temperature = ParseMeasurementField(tData);
+            a.solar_rad = ParseMeasurementField(srData);
+
+            atmosData.PushBack(a);
+        }
+
+        lineBegin = lineEnd + 1;
+    }
 }
 
 //----------------------------------------------------------------------------------
@@ -219,6 +502,251 @@ void ReadRowData(std::string & line, std::string & wastData, int wastIndex, std:
 
 //----------------------------------------------------------------------------------
 
+void ReadRowFields(const char * lineBegin, const char * lineEnd, FieldView & wastData, int wastIndex,
+                   FieldView & sData, int sIndex, FieldView & tData, int tIndex, FieldView & srData, int srIndex)
+{
+    wastData.begin = wastData.end = lineEnd;
+    sData.begin = sData.end = lineEnd;
+    tData.begin = tData.end = lineEnd;
+    srData.begin = srData.end = lineEnd;
+
+    int lastIndex = wastIndex;
+    if (sIndex > lastIndex)
+    {
+        lastIndex = sIndex;
+    }
+    if (tIndex > lastIndex)
+    {
+        lastIndex = tIndex;
+    }
+    if (srIndex > lastIndex)
+    {
+        lastIndex = srIndex;
+    }
+
+    // Walk the commas once, recording the bounds of the relevant columns
+    const char * start = lineBegin;
+    for (int columnIndex = 0; columnIndex <= lastIndex; columnIndex++)
+    {
+        const char * comma = static_cast<const char *>(std::memchr(start, ',', lineEnd - start));
+        const char * fieldEnd = (comma == nullptr) ? lineEnd : comma;
+
+        if (columnIndex == wastIndex)
+        {
+            wastData.begin = start;
+            wastData.end = fieldEnd;
+        }
+        else if (columnIndex == sIndex)
+        {
+            sData.begin = start;
+            sData.end = fieldEnd;
+        }
+        else if (columnIndex == tIndex)
+        {
+            tData.begin = start;
+            tData.end = fieldEnd;
+        }
+        else if (columnIndex == srIndex)
+        {
+            srData.begin = start;
+            srData.end = fieldEnd;
+        }
+
+        if (comma == nullptr)
+        {
+            break;
+        }
+        start = comma + 1;
+    }
+}
+
+//----------------------------------------------------------------------------------
+
+bool ParseDateTimeField(const FieldView & field, Date & d, MyTime & t)
+{
+    const char * p = field.begin;
+    int day, month, year, hour, minute;
+
+    if (!ScanInt(p, field.end, day) || p == field.end || *p++ != '/' ||
+        !ScanInt(p, field.end, month) || p == field.end || *p++ != '/' ||
+        !ScanInt(p, field.end, year))
+    {
+        return false;
+    }
+
+    while (p < field.end && *p == ' ')
+    {
+        p++;
+    }
+
+    if (!ScanInt(p, field.end, hour) || p == field.end || *p++ != ':' ||
+        !ScanInt(p, field.end, minute))
+    {
+        return false;
+    }
+
+    d.SetDay(day);
+    d.SetMonth(month);
+    d.SetYear(year);
+    t.SetHour(hour);
+    t.SetMinute(minute);
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+
+float ParseMeasurementField(const FieldView & field)
+{
+    int length = field.end - field.begin;
+    if (length == 0 || (length == 3 && std::memcmp(field.begin, "N/A", 3) == 0))
+    {
+        return -1.0f;
+    }
+
+    const char * p = field.begin;
+    float value;
+    if (!ScanFloat(p, field.end, value))
+    {
+        return -1.0f;
+    }
+    return value;
+}
+
+//----------------------------------------------------------------------------------
+
+bool ScanInt(const char * & p, const char * end, int & value)
+{
+    const char * start = p;
+    int result = 0;
+
+    while (p < end && *p >= '0' && *p <= '9')
+    {
+        result = result * 10 + (*p - '0');
+        p++;
+    }
+
+    value = result;
+    return p != start;
+}
+
+//----------------------------------------------------------------------------------
+
+bool ScanFloat(const char * & p, const char * end, float & value)
+{
+    // Every power of ten up to 1e22 is exactly representable as a double
+    static const double powersOfTen[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                         1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+    const char * q = p;
+    while (q < end && *q == ' ')
+    {
+        q++;
+    }
+    const char * numberBegin = q;
+
+    bool negative = false;
+    if (q < end && (*q == '-' || *q == '+'))
+    {
+        negative = (*q == '-');
+        q++;
+    }
+
+    unsigned long long mantissa = 0;
+    int significantDigits = 0, exponent = 0;
+    bool anyDigits = false, truncated = false;
+
+    while (q < end && *q >= '0' && *q <= '9')
+    {
+        if (significantDigits < 19)
+        {
+            mantissa = mantissa * 10 + (*q - '0');
+            if (mantissa != 0)
+            {
+                significantDigits++;
+            }
+        }
+        else
+        {
+            exponent++;
+            truncated = true;
+        }
+        anyDigits = true;
+        q++;
+    }
+
+    if (q < end && *q == '.')
+    {
+        q++;
+        while (q < end && *q >= '0' && *q <= '9')
+        {
+            if (significantDigits < 19)
+            {
+                mantissa = mantissa * 10 + (*q - '0');
+                if (mantissa != 0)
+                {
+                    significantDigits++;
+                }
+                exponent--;
+            }
+            else
+            {
+                truncated = true;
+            }
+            anyDigits = true;
+            q++;
+        }
+    }
+
+    if (!anyDigits)
+    {
+        return false;
+    }
+
+    if (q < end && (*q == 'e' || *q == 'E'))
+    {
+        const char * expPos = q + 1;
+        bool expNegative = false;
+        if (expPos < end && (*expPos == '-' || *expPos == '+'))
+        {
+            expNegative = (*expPos == '-');
+            expPos++;
+        }
+
+        int expValue;
+        if (ScanInt(expPos, end, expValue))
+        {
+            exponent += expNegative ? -expValue : expValue;
+            q = expPos;
+        }
+    }
+
+    // Fast path: an exact mantissa and an exact power of ten give a correctly rounded result
+    if (!truncated && mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22)
+    {
+        double result = static_cast<double>(mantissa);
+        result = (exponent < 0) ? result / powersOfTen[-exponent] : result * powersOfTen[exponent];
+        value = static_cast<float>(negative ? -result : result);
+        p = q;
+        return true;
+    }
+
+    // Slow path for unusual inputs, still without touching the heap
+    char buffer[64];
+    int length = q - numberBegin;
+    if (length >= static_cast<int>(sizeof(buffer)))
+    {
+        return false;
+    }
+    std::memcpy(buffer, numberBegin, length);
+    buffer[length] = '\0';
+
+    value = std::strtof(buffer, nullptr);
+    p = q;
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+
 void ParseDateRecord(std::string dateStr, Date & d)
 {
     int firstSlashInd = dateStr.find('/');
@@ -263,33 +791,26 @@ void WriteAtmosphereData(std::ofstream & file, const AtmosLogType & atmosData)
 
 //----------------------------------------------------------------------------------
 
-void TransferToBSTAndMap(const AtmosLogType & atmosData, BST<AtmosRecType> & bstData, std::map<int, AtmosLogType> & mapData)
+void TransferToIndexAndMap(const AtmosLogType & atmosData, EytzingerIndex<AtmosRecType> & indexData,
+                           std::map<int, AtmosColumns> & mapData)
 {
-    for (int i = 0; i < atmosData.GetSize(); i++)
-    {
-        const AtmosRecType & rec = atmosData[i];
-        mapData[rec.date.GetYear()].PushBack(rec);
-    }
-
     AtmosLogType sortedData = atmosData;
-    MergeSort(sortedData, 0, sortedData.GetSize() - 1);
-    BuildBalancedBST(bstData, sortedData, 0, sortedData.GetSize() - 1);
-}
-
-//----------------------------------------------------------------------------------
+    ParallelMergeSort(sortedData, 0, sortedData.GetSize() - 1);
 
-void BuildBalancedBST(BST<AtmosRecType> & bstData, const AtmosLogType & sortedData, int start, int end)
-{
-    if (start > end)
+    // Filling the columns from sorted data makes each month a contiguous range of its year
+    for (int i = 0; i < sortedData.GetSize(); i++)
     {
-        return;
+        const AtmosRecType & rec = sortedData[i];
+        AppendToColumns(mapData[rec.date.GetYear()], rec);
+    }
+    for (std::map<int, AtmosColumns>::iterator itr = mapData.begin(); itr != mapData.end(); ++itr)
+    {
+        IndexColumnMonths(itr->second);
+        SummariseColumnMonths(itr->second);
     }
 
-    int mid = (start + end) / 2;
-    bstData.Insert(sortedData[mid]);
-
-    BuildBalancedBST(bstData, sortedData, start, mid - 1);
-    BuildBalancedBST(bstData, sortedData, mid + 1, end);
+    // The menu only searches and scans the records, so it uses an index laid out for the cache rather than a tree
+    indexData.Build(sortedData);
 }
 
 //----------------------------------------------------------------------------------
@@ -5,27 +5,106 @@
 
 #include "atmospherelogtypes.h"
 #include "vector.h"
-#include "BST.h"
+#include "EytzingerIndex.h"
 #include <map>
 #include <string>
 #include <fstream>
 
+//----------------------------------------------------------------------------------
+
+/// Selects how LoadAtmosphereData reads the files listed in data_source.txt.
+enum IngestMode
+{
+    INGEST_STREAM, /// Reads each file line by line through std::ifstream and std::string.
+    INGEST_MAPPED, /// Memory-maps each file and scans fields in place without per-field allocation.
+    INGEST_PARALLEL, /// As INGEST_MAPPED, with the files parsed side by side, or as INGEST_CHUNKED if they are few.
+    INGEST_CHUNKED /// As INGEST_MAPPED, but each file is split into newline-aligned chunks parsed on worker threads.
+};
+
+/// The outcome of loading a single input file, used to report problems in data_source.txt order.
+enum LoadStatus
+{
+    LOAD_OK, /// The file was read and its records were stored.
+    LOAD_MISSING_FILE, /// The file could not be opened.
+    LOAD_MISSING_COLUMNS /// The file was opened but its header lacks a required column.
+};
+
+//----------------------------------------------------------------------------------
+
+/// A non-owning view of a single field inside a CSV buffer.
+typedef struct {
+    const char * begin; /// Pointer to the first character of the field.
+    const char * end; /// Pointer one past the last character of the field.
+} FieldView;
+
 //----------------------------------------------------------------------------------
 
     /**
     * @brief Loads atmospheric data from multiple input files listed in data_source.txt.
     *
     * This function opens the "data/data_source.txt" file and reads filenames line by line.
-    * For each listed file, it attempts to open and parse atmospheric records using ReadAtmosphereData().
+    * For each listed file, it attempts to open and parse atmospheric records using the selected ingest mode.
     * All valid data is appended to the provided AtmosLogType vector.
     *
     * @param atmosData A reference to an AtmosLogType (i.e., Vector of AtmosRecType) where all parsed records are stored.
+    * @param mode The ingest path used to read each file. INGEST_STREAM uses ReadAtmosphereData(), INGEST_MAPPED
+    *           uses ParseAtmosphereBuffer() over a memory-mapped view of the file, and INGEST_PARALLEL runs
+    *           LoadMappedFile() for all files at once on worker threads. INGEST_CHUNKED loads the files
+    *           one after another, but splits each of them across worker threads with ParseAtmosphereBufferChunked(),
+    *           which suits a few very large files. INGEST_PARALLEL falls back to INGEST_CHUNKED when fewer files
+    *           are listed than there are workers, so a single large export is still parsed on every worker.
+    *           Records are always stored in the order the files are listed, and problems are always reported in
+    *           that order.
+    * @param useCache Whether to use the binary cache file data/AtmosCache.bin. If the cache is still valid for the
+    *           listed files (see LoadAtmosCache()) the records are read from it and no CSV file is parsed;
+    *           otherwise the files are parsed and a new cache is written with SaveAtmosCache().
     * @return true if data_source.txt was successfully opened and at least one input file was attempted,
     *           and false if data_source.txt could not be opened.
     * @pre data/data_source.txt must exist and contain valid input filenames, one per line.
     * @post atmosData contains all valid parsed records from the listed files. Invalid files are skipped with a warning.
     */
-bool LoadAtmosphereData(AtmosLogType & atmosData);
+bool LoadAtmosphereData(AtmosLogType & atmosData, IngestMode mode = INGEST_PARALLEL, bool useCache = true);
+
+    /**
+    * @brief Loads the atmospheric records of a single data file through std::ifstream.
+    *
+    * Opens "data/" + filename and parses it with ReadAtmosphereData(). Nothing is printed; the returned status is
+    * passed to ReportLoadStatus() by the caller.
+    *
+    * @param filename - The file name as listed in data_source.txt.
+    * @param atmosData - A reference to a vector to which the parsed records are appended.
+    * @return LOAD_OK, LOAD_MISSING_FILE or LOAD_MISSING_COLUMNS.
+    * @pre None.
+    * @post If LOAD_OK is returned, all valid records of the file are appended to atmosData.
+    */
+LoadStatus LoadStreamFile(const std::string & filename, AtmosLogType & atmosData);
+
+    /**
+    * @brief Loads the atmospheric records of a single data file through a memory mapping.
+    *
+    * Maps "data/" + filename and parses it with ParseAtmosphereBuffer(), or ParseAtmosphereBufferChunked() when
+    * chunked is true. Nothing is printed, so that the function can run on a worker thread; the returned status is
+    * passed to ReportLoadStatus() by the caller.
+    *
+    * @param filename - The file name as listed in data_source.txt.
+    * @param atmosData - A reference to a vector to which the parsed records are appended.
+    * @param chunked - Whether the file itself is split across worker threads.
+    * @return LOAD_OK, LOAD_MISSING_FILE or LOAD_MISSING_COLUMNS.
+    * @pre None.
+    * @post If LOAD_OK is returned, all valid records of the file are appended to atmosData.
+    */
+LoadStatus LoadMappedFile(const std::string & filename, AtmosLogType & atmosData, bool chunked = false);
+
+    /**
+    * @brief Prints the warning for a file that could not be loaded.
+    *
+    * @param status - The status returned when the file was loaded.
+    * @param filename - The file name as listed in data_source.txt.
+    * @return void
+    * @pre None.
+    * @post The same warning as the stream path is printed for a failed file; nothing is printed for LOAD_OK.
+    */
+void ReportLoadStatus(LoadStatus status, const std::string & filename);
 
     /**
     * @brief Reads atmospheric data from a file into a structured vector.
@@ -34,13 +113,99 @@ bool LoadAtmosphereData(AtmosLogType & atmosData);
     * temperature, and solar radiation. Handles missing or invalid data by
     * setting those values to -1.0f. Extracted values are stored in AtmosRecType
     * objects which are inserted into a Vector passed as a reference parameter.
+    * Lines may end with LF or CRLF.
     *
     * @param file - Input file stream containing atmospheric CSV data.
     * @param atmosData - A reference to a vector containing the parsed atmospheric records.
+    * @return true if the header contained all required columns, false otherwise.
     * @pre file must be open and contain valid CSV data with appropriate headers.
     * @post All valid records from the file are parsed and stored in the returned vector.
     */
-void ReadAtmosphereData(std::ifstream & file, AtmosLogType & atmosData);
+bool ReadAtmosphereData(std::ifstream & file, AtmosLogType & atmosData);
+
+    /**
+    * @brief Removes the carriage return that ends a line read from a file with CRLF line endings.
+    *
+    * @param line - A line read by std::getline.
+    * @return A reference to line.
+    * @pre None.
+    * @post line does not end with '\r'.
+    */
+std::string & StripCarriageReturn(std::string & line);
+
+    /**
+    * @brief Parses atmospheric records directly from an in-memory CSV buffer.
+    *
+    * Performs the same parsing as ReadAtmosphereData(), but reads fields in place from the bytes between
+    * begin and end (typically a memory-mapped file) using FieldView and the Scan functions, so that no
+    * heap allocation is made per row or per field. Only the header line is copied into a std::string so
+    * that GetColumnIndices() can be reused. Lines may end with LF or CRLF, and the last line needs no newline.
+    *
+    * @param begin - Pointer to the first byte of the CSV data, including the header line.
+    * @param end - Pointer one past the last byte of the CSV data.
+    * @param atmosData - A reference to a vector to which the parsed atmospheric records are appended.
+    * @return true if the header contained all required columns, false otherwise.
+    * @pre [begin, end) is a readable range (it may be empty).
+    * @post All valid records in the buffer are parsed and appended to atmosData.
+    */
+bool ParseAtmosphereBuffer(const char * begin, const char * end, AtmosLogType & atmosData);
+
+    /**
+    * @brief Parses atmospheric records from an in-memory CSV buffer on several threads.
+    *
+    * Reads the header once with ParseBufferHeader(), then splits the remaining rows into byte ranges of
+    * roughly equal size. Each range boundary is moved forward to just after the next newline, so every row
+    * falls into exactly one range. The ranges are parsed with ParseAtmosphereRows() on worker threads into
+    * separate vectors, which are then appended to atmosData in range order. The result is identical to
+    * ParseAtmosphereBuffer(). Buffers smaller than MIN_CHUNK_BYTES per worker use fewer workers.
+    *
+    * @param begin - Pointer to the first byte of the CSV data, including the header line.
+    * @param end - Pointer one past the last byte of the CSV data.
+    * @param atmosData - A reference to a vector to which the parsed atmospheric records are appended.
+    * @return true if the header contained all required columns, false otherwise.
+    * @pre [begin, end) is a readable range (it may be empty).
+    * @post All valid records in the buffer are appended to atmosData in file order.
+    */
+bool ParseAtmosphereBufferChunked(const char * begin, const char * end, AtmosLogType & atmosData);
+
+    /**
+    * @brief Reads the header line of an in-memory CSV buffer.
+    *
+    * Finds the column indices with GetColumnIndices() and locates the first data row.
+    *
+    * @param begin - Pointer to the first byte of the CSV data.
+    * @param end - Pointer one past the last byte of the CSV data.
+    * @param rowsBegin - Output parameter set to the first byte after the header line.
+    * @param wastIndex - Output parameter to store the index of the WAST column.
+    * @param sIndex - Output parameter to store the index of the S (Speed) column.
+    * @param tIndex - Output parameter to store the index of the T (Temperature) column.
+    * @param srIndex - Output parameter to store the index of the SR (Solar Radiation) column.
+    * @return true if there is a header containing all required columns, false otherwise.
+    * @pre [begin, end) is a readable range (it may be empty).
+    * @post If successful, the indices are set and [rowsBegin, end) holds the data rows.
+    */
+bool ParseBufferHeader(const char * begin, const char * end, const char * & rowsBegin,
+                       int & wastIndex, int & sIndex, int & tIndex, int & srIndex);
+
+    /**
+    * @brief Parses the data rows in a CSV buffer using known column indices.
+    *
+    * The row-parsing half of ParseAtmosphereBuffer(). The range must start at the beginning of a data row
+    * and must not contain the header line.
+    *
+    * @param begin - Pointer to the first byte of the first row.
+    * @param end - Pointer one past the last byte of the last row.
+    * @param wastIndex - Column index for WAST.
+    * @param sIndex - Column index for Speed.
+    * @param tIndex - Column index for Temperature.
+    * @param srIndex - Column index for Solar Radiation.
+    * @param atmosData - A reference to a vector to which the parsed atmospheric records are appended.
+    * @return void
+    * @pre The indices were obtained from GetColumnIndices() on the header of the same file.
+    * @post All valid records in the range are parsed and appended to atmosData.
+    */
+void ParseAtmosphereRows(const char * begin, const char * end, int wastIndex, int sIndex, int tIndex, int srIndex,
+                         AtmosLogType & atmosData);
 
     /**
     * @brief Finds the column indices of WAST, S, T, and SR from the header line.
@@ -81,6 +246,82 @@ bool GetColumnIndices(std::string & headerLine, int & wastIndex, int & sIndex, i
 void ReadRowData(std::string & line, std::string & wastData, int wastIndex, std::string & sData, int sIndex,
                  std::string & tData, int tIndex, std::string & srData, int srIndex);
 
+    /**
+    * @brief Locates the WAST, S, T and SR fields in a single CSV row without copying them.
+    *
+    * The allocation-free counterpart of ReadRowData(). Columns that are not present in the row are left as
+    * empty views.
+    *
+    * @param lineBegin - Pointer to the first character of the row.
+    * @param lineEnd - Pointer one past the last character of the row (excluding the newline).
+    * @param wastData - Reference to store the view of the WAST (Date and Time) field.
+    * @param wastIndex - Column index for WAST.
+    * @param sData - Reference to store the view of the Speed field.
+    * @param sIndex - Column index for Speed.
+    * @param tData - Reference to store the view of the Temperature field.
+    * @param tIndex - Column index for Temperature.
+    * @param srData - Reference to store the view of the Solar Radiation field.
+    * @param srIndex - Column index for Solar Radiation.
+    * @return void
+    * @pre [lineBegin, lineEnd) is a readable range.
+    * @post The four views point into the row, or are empty if their column does not exist.
+    */
+void ReadRowFields(const char * lineBegin, const char * lineEnd, FieldView & wastData, int wastIndex,
+                   FieldView & sData, int sIndex, FieldView & tData, int tIndex, FieldView & srData, int srIndex);
+
+    /**
+    * @brief Parses a WAST field ("D/M/YYYY H:MM") into a Date and MyTime object.
+    *
+    * @param field - View of the WAST field.
+    * @param d - Reference to a Date object that will be populated.
+    * @param t - Reference to a MyTime object that will be populated.
+    * @return true if the field contained a well-formed date and time, false otherwise.
+    * @pre None.
+    * @post If successful, d and t contain the parsed date and time.
+    */
+bool ParseDateTimeField(const FieldView & field, Date & d, MyTime & t);
+
+    /**
+    * @brief Parses a measurement field into a float, using -1.0f for missing values.
+    *
+    * Empty fields and "N/A" are treated as missing, matching ReadAtmosphereData().
+    *
+    * @param field - View of the measurement field.
+    * @return The parsed value, or -1.0f if the field is missing or not a number.
+    * @pre None.
+    * @post None.
+    */
+float ParseMeasurementField(const FieldView & field);
+
+    /**
+    * @brief Scans a non-negative decimal integer.
+    *
+    * Reads consecutive digits starting at p and advances p past them.
+    *
+    * @param p - Reference to the current read position, advanced past the digits read.
+    * @param end - Pointer one past the last readable character.
+    * @param value - Reference to store the scanned integer.
+    * @return true if at least one digit was read, false otherwise.
+    * @pre [p, end) is a readable range.
+    * @post p points to the first character that is not a digit.
+    */
+bool ScanInt(const char * & p, const char * end, int & value);
+
+    /**
+    * @brief Scans a decimal floating point number such as "-12.75" or "1.5e3".
+    *
+    * Leading spaces are skipped. Numbers with up to 19 significant digits and a small exponent are converted
+    * exactly using a power-of-ten table; anything else falls back to strtof() on a small stack buffer.
+    *
+    * @param p - Reference to the current read position, advanced past the number read.
+    * @param end - Pointer one past the last readable character.
+    * @param value - Reference to store the scanned number.
+    * @return true if a number was read, false otherwise.
+    * @pre [p, end) is a readable range.
+    * @post If successful, p points to the first character after the number.
+    */
+bool ScanFloat(const char * & p, const char * end, float & value);
+
     /**
     * @brief Parse a date string into a Date object.
     *
@@ -123,36 +364,24 @@ void ParseTimeRecord(std::string timeStr, MyTime & t);
 void WriteAtmosphereData(std::ofstream & file, const AtmosLogType & atmosData);
 
     /**
-    * @brief Transfers data from AtmosRecType vector to BST and map structures
+    * @brief Transfers data from AtmosRecType vector to search index and map structures
     *
-    * This method transfers the data from the AtmosRecType vector (AtmosLogType) to a BST and an std::map.
-    * It orders the data into the map using the month integer as the key.
+    * This method transfers the data from the AtmosRecType vector (AtmosLogType) to an EytzingerIndex and an std::map.
+    * It sorts a copy of the data with ParallelMergeSort(), then appends each record to the AtmosColumns store of
+    * its year, so that every year's columns are in chronological order and each month is a contiguous range. The summary statistics
+    * of every (year, month) are computed once here, so the monthly menu statistics do not need to read the records.
+    * The index is built straight from the sorted copy, which is freed on return.
     *
     * @param atmosData - the reference to the AtmosRecType vector, AtmosLogType.
-    * @param bstData - the reference to the AtmosRecType Binary Search Tree.
-    * @param mapData - the reference to the AtmosLogType Map with month integers as the keys.
-    * @return void
-    * @pre atmosData, bstData and mapData are valid and properly constructed.
-    * @post bstData contains all records from atmosData. mapData contains records indexed by month.
-    */
-void TransferToBSTAndMap(const AtmosLogType & atmosData, BST<AtmosRecType> & bstData, std::map<int, AtmosLogType> & mapData);
-
-    /**
-    * @brief Recursively builds a height-balanced Binary Search Tree from sorted atmospheric data.
-    *
-    * This function uses a recursive divide-and-conquer strategy to construct a balanced BST
-    * by inserting the middle element of the current range, then repeating the process for
-    * the left and right subranges.
-    *
-    * @param bstData A reference to the BST where the balanced nodes will be inserted.
-    * @param sortedData A const reference to a sorted AtmosLogType (vector of AtmosRecType).
-    * @param start The starting index of the current range in the sorted vector.
-    * @param end The ending index of the current range in the sorted vector.
+    * @param indexData - the reference to the AtmosRecType search index.
+    * @param mapData - the reference to the AtmosColumns Map with year integers as the keys.
     * @return void
-    * @pre sortedData must be sorted by the desired BST ordering criteria (e.g., Date/Time).
-    * @post bstData is populated with a balanced BST containing all elements from sortedData[start] to sortedData[end].
+    * @pre atmosData, indexData and mapData are valid and properly constructed.
+    * @post indexData holds each distinct record from atmosData, as built by EytzingerIndex::Build().
+    * mapData contains records indexed by year, with month ranges and summaries.
     */
-void BuildBalancedBST(BST<AtmosRecType> & bstData, const AtmosLogType & sortedData, int start, int end);
+void TransferToIndexAndMap(const AtmosLogType & atmosData, EytzingerIndex<AtmosRecType> & indexData,
+                           std::map<int, AtmosColumns> & mapData);
 
 //----------------------------------------------------------------------------------
 
@@ -0,0 +1,738 @@
+#include "FloatKernels.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FLOAT_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+//----------------------------------------------------------------------------------
+
+static double ScalarSum(const float * x, int n);
+
+static double ScalarSumSquaredDiff(const float * x, int n, float c);
+
+static double ScalarSumCrossDiff(const float * x, const float * y, int n, float cx, float cy);
+
+static double ScalarSumAbsDiff(const float * x, int n, float c);
+
+static double ScalarSumSkipping(const float * x, int n, float skip, int * count);
+
+static double ScalarSumSquaredAbsDiffSkipping(const float * x, int n, float c, float skip, double * absSum);
+
+#ifdef FLOAT_KERNELS_X86
+
+static double Sse2Sum(const float * x, int n);
+
+static double Sse2SumSquaredDiff(const float * x, int n, float c);
+
+static double Sse2SumCrossDiff(const float * x, const float * y, int n, float cx, float cy);
+
+static double Sse2SumAbsDiff(const float * x, int n, float c);
+
+static double Sse2SumSkipping(const float * x, int n, float skip, int * count);
+
+static double Sse2SumSquaredAbsDiffSkipping(const float * x, int n, float c, float skip, double * absSum);
+
+static double Avx2Sum(const float * x, int n);
+
+static double Avx2SumSquaredDiff(const float * x, int n, float c);
+
+static double Avx2SumCrossDiff(const float * x, const float * y, int n, float cx, float cy);
+
+static double Avx2SumAbsDiff(const float * x, int n, float c);
+
+static double Avx2SumSkipping(const float * x, int n, float skip, int * count);
+
+static double Avx2SumSquaredAbsDiffSkipping(const float * x, int n, float c, float skip, double * absSum);
+
+#endif
+
+//----------------------------------------------------------------------------------
+
+// Classes cannot be declared static, so the accumulators are kept private to this file by an unnamed namespace
+namespace
+{
+
+/// Adds a sequence of doubles with Neumaier's variant of Kahan summation, which also keeps the low bits of a term
+/// larger than the running sum.
+class NeumaierSum
+{
+public:
+    NeumaierSum() : m_sum(0), m_compensation(0) {}
+
+    void Add(double value)
+    {
+        double total = m_sum + value;
+        if (std::fabs(m_sum) >= std::fabs(value))
+        {
+            m_compensation += (m_sum - total) + value;
+        }
+        else
+        {
+            m_compensation += (value - total) + m_sum;
+        }
+        m_sum = total;
+    }
+
+    double GetResult() const { return m_sum + m_compensation; }
+private:
+    double m_sum; /// The running sum.
+    double m_compensation; /// The low bits lost from m_sum so far.
+};
+
+/// Adds a sequence of doubles pairwise without storing them: the partial sums form a binary counter, and the
+/// k-th value added merges one partial sum for each trailing one bit of k.
+class PairwiseSum
+{
+public:
+    PairwiseSum() : m_count(0), m_depth(0) {}
+
+    void Add(double value)
+    {
+        for (unsigned int merged = m_count; merged & 1; merged >>= 1)
+        {
+            value = m_partial[--m_depth] + value;
+        }
+        m_partial[m_depth++] = value;
+        m_count++;
+    }
+
+    double GetResult() const
+    {
+        double result = 0;
+        for (int level = m_depth - 1; level >= 0; level--)
+        {
+            result = m_partial[level] + result;
+        }
+        return result;
+    }
+private:
+    unsigned int m_count; /// The number of values added.
+    int m_depth; /// The number of partial sums held, one per one bit of m_count.
+    double m_partial[32]; /// The partial sums, the largest first.
+};
+
+} // namespace
+
+template <class Accumulator, double (*Kernel)(const float *, int)>
+static double BlockedSum(const float * x, int n);
+
+template <class Accumulator, double (*Kernel)(const float *, int, float)>
+static double BlockedSumDiff(const float * x, int n, float c);
+
+template <class Accumulator, double (*Kernel)(const float *, const float *, int, float, float)>
+static double BlockedSumCrossDiff(const float * x, const float * y, int n, float cx, float cy);
+
+template <class Accumulator, double (*Kernel)(const float *, int, float, int *)>
+static double BlockedSumSkipping(const float * x, int n, float skip, int * count);
+
+template <class Accumulator, double (*Kernel)(const float *, int, float, float, double *)>
+static double BlockedSumSquaredAbsDiffSkipping(const float * x, int n, float c, float skip, double * absSum);
+
+//----------------------------------------------------------------------------------
+
+const FloatKernels SCALAR_KERNELS[] = {
+    {KERNEL_SCALAR, SUMMATION_DOUBLE, "scalar", ScalarSum, ScalarSumSquaredDiff, ScalarSumCrossDiff, ScalarSumAbsDiff,
+     ScalarSumSkipping, ScalarSumSquaredAbsDiffSkipping},
+    {KERNEL_SCALAR, SUMMATION_NEUMAIER, "scalar", BlockedSum<NeumaierSum, ScalarSum>,
+     BlockedSumDiff<NeumaierSum, ScalarSumSquaredDiff>, BlockedSumCrossDiff<NeumaierSum, ScalarSumCrossDiff>,
+     BlockedSumDiff<NeumaierSum, ScalarSumAbsDiff>, BlockedSumSkipping<NeumaierSum, ScalarSumSkipping>,
+     BlockedSumSquaredAbsDiffSkipping<NeumaierSum, ScalarSumSquaredAbsDiffSkipping>},
+    {KERNEL_SCALAR, SUMMATION_PAIRWISE, "scalar", BlockedSum<PairwiseSum, ScalarSum>,
+     BlockedSumDiff<PairwiseSum, ScalarSumSquaredDiff>, BlockedSumCrossDiff<PairwiseSum, ScalarSumCrossDiff>,
+     BlockedSumDiff<PairwiseSum, ScalarSumAbsDiff>, BlockedSumSkipping<PairwiseSum, ScalarSumSkipping>,
+     BlockedSumSquaredAbsDiffSkipping<PairwiseSum, ScalarSumSquaredAbsDiffSkipping>}
+};
+
+#ifdef FLOAT_KERNELS_X86
+
+const FloatKernels SSE2_KERNELS[] = {
+    {KERNEL_SSE2, SUMMATION_DOUBLE, "SSE2", Sse2Sum, Sse2SumSquaredDiff, Sse2SumCrossDiff, Sse2SumAbsDiff,
+     Sse2SumSkipping, Sse2SumSquaredAbsDiffSkipping},
+    {KERNEL_SSE2, SUMMATION_NEUMAIER, "SSE2", BlockedSum<NeumaierSum, Sse2Sum>,
+     BlockedSumDiff<NeumaierSum, Sse2SumSquaredDiff>, BlockedSumCrossDiff<NeumaierSum, Sse2SumCrossDiff>,
+     BlockedSumDiff<NeumaierSum, Sse2SumAbsDiff>, BlockedSumSkipping<NeumaierSum, Sse2SumSkipping>,
+     BlockedSumSquaredAbsDiffSkipping<NeumaierSum, Sse2SumSquaredAbsDiffSkipping>},
+    {KERNEL_SSE2, SUMMATION_PAIRWISE, "SSE2", BlockedSum<PairwiseSum, Sse2Sum>,
+     BlockedSumDiff<PairwiseSum, Sse2SumSquaredDiff>, BlockedSumCrossDiff<PairwiseSum, Sse2SumCrossDiff>,
+     BlockedSumDiff<PairwiseSum, Sse2SumAbsDiff>, BlockedSumSkipping<PairwiseSum, Sse2SumSkipping>,
+     BlockedSumSquaredAbsDiffSkipping<PairwiseSum, Sse2SumSquaredAbsDiffSkipping>}
+};
+
+const FloatKernels AVX2_KERNELS[] = {
+    {KERNEL_AVX2, SUMMATION_DOUBLE, "AVX2", Avx2Sum, Avx2SumSquaredDiff, Avx2SumCrossDiff, Avx2SumAbsDiff,
+     Avx2SumSkipping, Avx2SumSquaredAbsDiffSkipping},
+    {KERNEL_AVX2, SUMMATION_NEUMAIER, "AVX2", BlockedSum<NeumaierSum, Avx2Sum>,
+     BlockedSumDiff<NeumaierSum, Avx2SumSquaredDiff>, BlockedSumCrossDiff<NeumaierSum, Avx2SumCrossDiff>,
+     BlockedSumDiff<NeumaierSum, Avx2SumAbsDiff>, BlockedSumSkipping<NeumaierSum, Avx2SumSkipping>,
+     BlockedSumSquaredAbsDiffSkipping<NeumaierSum, Avx2SumSquaredAbsDiffSkipping>},
+    {KERNEL_AVX2, SUMMATION_PAIRWISE, "AVX2", BlockedSum<PairwiseSum, Avx2Sum>,
+     BlockedSumDiff<PairwiseSum, Avx2SumSquaredDiff>, BlockedSumCrossDiff<PairwiseSum, Avx2SumCrossDiff>,
+     BlockedSumDiff<PairwiseSum, Avx2SumAbsDiff>, BlockedSumSkipping<PairwiseSum, Avx2SumSkipping>,
+     BlockedSumSquaredAbsDiffSkipping<PairwiseSum, Avx2SumSquaredAbsDiffSkipping>}
+};
+
+#endif
+
+//----------------------------------------------------------------------------------
+
+bool IsKernelLevelSupported(KernelLevel level)
+{
+    switch (level)
+    {
+    case KERNEL_SCALAR:
+        return true;
+#ifdef FLOAT_KERNELS_X86
+    case KERNEL_SSE2:
+        return __builtin_cpu_supports("sse2");
+    case KERNEL_AVX2:
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+    default:
+        return false;
+    }
+}
+
+//----------------------------------------------------------------------------------
+
+KernelLevel GetBestKernelLevel()
+{
+    // Initialised once, on the first call, which C++11 makes safe when several threads arrive at once
+    static const KernelLevel best = IsKernelLevelSupported(KERNEL_AVX2) ? KERNEL_AVX2
+                                    : IsKernelLevelSupported(KERNEL_SSE2) ? KERNEL_SSE2 : KERNEL_SCALAR;
+    return best;
+}
+
+//----------------------------------------------------------------------------------
+
+const FloatKernels & GetFloatKernels(KernelLevel level, SummationPolicy policy)
+{
+#ifdef FLOAT_KERNELS_X86
+    if (level == KERNEL_AVX2)
+    {
+        return AVX2_KERNELS[policy];
+    }
+    if (level == KERNEL_SSE2)
+    {
+        return SSE2_KERNELS[policy];
+    }
+#endif
+    return SCALAR_KERNELS[policy];
+}
+
+//----------------------------------------------------------------------------------
+
+const FloatKernels & GetBestFloatKernels(SummationPolicy policy)
+{
+    return GetFloatKernels(GetBestKernelLevel(), policy);
+}
+
+//----------------------------------------------------------------------------------
+
+const char * GetSummationPolicyName(SummationPolicy policy)
+{
+    switch (policy)
+    {
+    case SUMMATION_NEUMAIER:
+        return "Neumaier";
+    case SUMMATION_PAIRWISE:
+        return "pairwise";
+    default:
+        return "double";
+    }
+}
+
+//----------------------------------------------------------------------------------
+
+template <class Accumulator, double (*Kernel)(const float *, int)>
+static double BlockedSum(const float * x, int n)
+{
+    Accumulator sum;
+    for (int i = 0; i < n; i += SUMMATION_BLOCK)
+    {
+        sum.Add(Kernel(x + i, std::min(SUMMATION_BLOCK, n - i)));
+    }
+    return sum.GetResult();
+}
+
+//----------------------------------------------------------------------------------
+
+template <class Accumulator, double (*Kernel)(const float *, int, float)>
+static double BlockedSumDiff(const float * x, int n, float c)
+{
+    Accumulator sum;
+    for (int i = 0; i < n; i += SUMMATION_BLOCK)
+    {
+        sum.Add(Kernel(x + i, std::min(SUMMATION_BLOCK, n - i), c));
+    }
+    return sum.GetResult();
+}
+
+//----------------------------------------------------------------------------------
+
+template <class Accumulator, double (*Kernel)(const float *, const float *, int, float, float)>
+static double BlockedSumCrossDiff(const float * x, const float * y, int n, float cx, float cy)
+{
+    Accumulator sum;
+    for (int i = 0; i < n; i += SUMMATION_BLOCK)
+    {
+        sum.Add(Kernel(x + i, y + i, std::min(SUMMATION_BLOCK, n - i), cx, cy));
+    }
+    return sum.GetResult();
+}
+
+//----------------------------------------------------------------------------------
+
+template <class Accumulator, double (*Kernel)(const float *, int, float, int *)>
+static double BlockedSumSkipping(const float * x, int n, float skip, int * count)
+{
+    Accumulator sum;
+    *count = 0;
+    for (int i = 0; i < n; i += SUMMATION_BLOCK)
+    {
+        int blockCount = 0;
+        sum.Add(Kernel(x + i, std::min(SUMMATION_BLOCK, n - i), skip, &blockCount));
+        *count += blockCount;
+    }
+    return sum.GetResult();
+}
+
+//----------------------------------------------------------------------------------
+
+template <class Accumulator, double (*Kernel)(const float *, int, float, float, double *)>
+static double BlockedSumSquaredAbsDiffSkipping(const float * x, int n, float c, float skip, double * absSum)
+{
+    Accumulator squared;
+    Accumulator absolute;
+    for (int i = 0; i < n; i += SUMMATION_BLOCK)
+    {
+        double blockAbs = 0;
+        squared.Add(Kernel(x + i, std::min(SUMMATION_BLOCK, n - i), c, skip, &blockAbs));
+        absolute.Add(blockAbs);
+    }
+    *absSum = absolute.GetResult();
+    return squared.GetResult();
+}
+
+//----------------------------------------------------------------------------------
+
+static double ScalarSum(const float * x, int n)
+{
+    double sum = 0;
+    for (int i = 0; i < n; i++)
+    {
+        sum += x[i];
+    }
+    return sum;
+}
+
+//----------------------------------------------------------------------------------
+
+static double ScalarSumSquaredDiff(const float * x, int n, float c)
+{
+    double sum = 0;
+    for (int i = 0; i < n; i++)
+    {
+        double diff = x[i] - c;
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+//----------------------------------------------------------------------------------
+
+static double ScalarSumCrossDiff(const float * x, const float * y, int n, float cx, float cy)
+{
+    double sum = 0;
+    for (int i = 0; i < n; i++)
+    {
+        sum += static_cast<double>(x[i] - cx) * (y[i] - cy);
+    }
+    return sum;
+}
+
+//----------------------------------------------------------------------------------
+
+static double ScalarSumAbsDiff(const float * x, int n, float c)
+{
+    double sum = 0;
+    for (int i = 0; i < n; i++)
+    {
+        sum += std::fabs(x[i] - c);
+    }
+    return sum;
+}
+
+//----------------------------------------------------------------------------------
+
+static double ScalarSumSkipping(const float * x, int n, float skip, int * count)
+{
+    double sum = 0;
+    int kept = 0;
+    for (int i = 0; i < n; i++)
+    {
+        if (x[i] != skip)
+        {
+            sum += x[i];
+            kept++;
+        }
+    }
+    *count = kept;
+    return sum;
+}
+
+//----------------------------------------------------------------------------------
+
+static double ScalarSumSquaredAbsDiffSkipping(const float * x, int n, float c, float skip, double * absSum)
+{
+    double squared = 0;
+    double absolute = 0;
+    for (int i = 0; i < n; i++)
+    {
+        if (x[i] != skip)
+        {
+            double diff = x[i] - c;
+            squared += diff * diff;
+            absolute += std::fabs(diff);
+        }
+    }
+    *absSum = absolute;
+    return squared;
+}
+
+//----------------------------------------------------------------------------------
+
+#ifdef FLOAT_KERNELS_X86
+
+// Each SSE2 kernel works on 4 floats at a time. The differences are taken in float, as the scalar kernels do,
+// and widened to two pairs of doubles, which go to separate accumulators so consecutive additions do not wait
+// on each other. The last n % 4 values go through the scalar kernel.
+
+/// The bits of a float other than its sign, for taking absolute values with a bitwise and.
+static const int FLOAT_ABS_MASK = 0x7fffffff;
+
+//----------------------------------------------------------------------------------
+
+__attribute__((target("sse2")))
+static double Sse2HorizontalSum(__m128d a, __m128d b)
+{
+    __m128d both = _mm_add_pd(a, b);
+    return _mm_cvtsd_f64(_mm_add_sd(both, _mm_unpackhi_pd(both, both)));
+}
+
+//----------------------------------------------------------------------------------
+
+__attribute__((target("sse2")))
+static int Sse2LaneTotal(__m128i counts)
+{
+    int lanes[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), counts);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+//----------------------------------------------------------------------------------
+
+__attribute__((target("sse2")))
+static double Sse2Sum(const float * x, int n)
+{
+    __m128d lo = _mm_setzero_pd();
+    __m128d hi = _mm_setzero_pd();
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 v = _mm_loadu_ps(x + i);
+        lo = _mm_add_pd(lo, _mm_cvtps_pd(v));
+        hi = _mm_add_pd(hi, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+    }
+    return Sse2HorizontalSum(lo, hi) + ScalarSum(x + i, n - i);
+}
+
+//----------------------------------------------------------------------------------
+
+__attribute__((target("sse2")))
+static double Sse2SumSquaredDiff(const float * x, int n, float c)
+{
+    __m128 center = _mm_set1_ps(c);
+    __m128d lo = _mm_setzero_pd();
+    __m128d hi = _mm_setzero_pd();
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 diff = _mm_sub_ps(_mm_loadu_ps(x + i), center);
+        __m128d dlo = _mm_cvtps_pd(diff);
+        __m128d dhi = _mm_cvtps_pd(_mm_movehl_ps(diff, diff));
+        lo = _mm_add_pd(lo, _mm_mul_pd(dlo, dlo));
+        hi = _mm_add_pd(hi, _mm_mul_pd(dhi, dhi));
+    }
+    return Sse2HorizontalSum(lo, hi) + ScalarSumSquaredDiff(x + i, n - i, c);
+}
+
+//----------------------------------------------------------------------------------
+
+__attribute__((target("sse2")))
+static double Sse2SumCrossDiff(const float * x, const float * y, int n, float cx, float cy)
+{
+    __m128 centerX = _mm_set1_ps(cx);
+    __m128 centerY = _mm_set1_ps(cy);
+    __m128d lo = _mm_setzero_pd();
+    __m128d hi = _mm_setzero_pd();
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(x + i), centerX);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(y + i), centerY);
+        lo = _mm_add_pd(lo, _mm_mul_pd(_mm_cvtps_pd(dx), _mm_cvtps_pd(dy)));
+        hi = _mm_add_pd(hi, _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(dx, dx)), _mm_cvtps_pd(_mm_movehl_ps(dy, dy))));
+    }
+    return Sse2HorizontalSum(lo, hi) + ScalarSumCrossDiff(x + i, y + i, n - i, cx, cy);
+}
+
+//----------------------------------------------------------------------------------
+
+__attribute__((target("sse2")))
+static double Sse2SumAbsDiff(const float * x, int n, float c)
+{
+    __m128 center = _mm_set1_ps(c);
+    __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(FLOAT_ABS_MASK));
+    __m128d lo = _mm_setzero_pd();
+    __m128d hi = _mm_setzero_pd();
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 diff = _mm_and_ps(_mm_sub_ps(_mm_loadu_ps(x + i), center), absMask);
+        lo = _mm_add_pd(lo, _mm_cvtps_pd(diff));
+        hi = _mm_add_pd(hi, _mm_cvtps_pd(_mm_movehl_ps(diff, diff)));
+    }
+    return Sse2HorizontalSum(lo, hi) + ScalarSumAbsDiff(x + i, n - i, c);
+}
+
+//----------------------------------------------------------------------------------
+
+__attribute__((target("sse2")))
+static double Sse2SumSkipping(const float * x, int n, float skip, int * count)
+{
+    __m128 skipped = _mm_set1_ps(skip);
+    __m128d lo = _mm_setzero_pd();
+    __m128d hi = _mm_setzero_pd();
+    __m128i kept = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 v = _mm_loadu_ps(x + i);
+        // Lanes holding skip get a mask of 0, which zeroes their value; the others are all ones, i.e. -1
+        __m128 keep = _mm_cmpneq_ps(v, skipped);
+        __m128 masked = _mm_and_ps(v, keep);
+        lo = _mm_add_pd(lo, _mm_cvtps_pd(masked));
+        hi = _mm_add_pd(hi, _mm_cvtps_pd(_mm_movehl_ps(masked, masked)));
+        kept = _mm_sub_epi32(kept, _mm_castps_si128(keep));
+    }
+
+    int tailCount = 0;
+    double sum = Sse2HorizontalSum(lo, hi) + ScalarSumSkipping(x + i, n - i, skip, &tailCount);
+    *count = Sse2LaneTotal(kept) + tailCount;
+    return sum;
+}
+
+//----------------------------------------------------------------------------------
+
+__attribute__((target("sse2")))
+static double Sse2SumSquaredAbsDiffSkipping(const float * x, int n, float c, float skip, double * absSum)
+{
+    __m128 center = _mm_set1_ps(c);
+    __m128 skipped = _mm_set1_ps(skip);
+    __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(FLOAT_ABS_MASK));
+    __m128d squaredLo = _mm_setzero_pd();
+    __m128d squaredHi = _mm_setzero_pd();
+    __m128d absLo = _mm_setzero_pd();
+    __m128d absHi = _mm_setzero_pd();
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 v = _mm_loadu_ps(x + i);
+        __m128 diff = _mm_and_ps(_mm_sub_ps(v, center), _mm_cmpneq_ps(v, skipped));
+        __m128 absDiff = _mm_and_ps(diff, absMask);
+        __m128d dlo = _mm_cvtps_pd(diff);
+        __m128d dhi = _mm_cvtps_pd(_mm_movehl_ps(diff, diff));
+        squaredLo = _mm_add_pd(squaredLo, _mm_mul_pd(dlo, dlo));
+        squaredHi = _mm_add_pd(squaredHi, _mm_mul_pd(dhi, dhi));
+        absLo = _mm_add_pd(absLo, _mm_cvtps_pd(absDiff));
+        absHi = _mm_add_pd(absHi, _mm_cvtps_pd(_mm_movehl_ps(absDiff, absDiff)));
+    }
+
+    double tailAbs = 0;
+    double squared = Sse2HorizontalSum(squaredLo, squaredHi) +
+                     ScalarSumSquaredAbsDiffSkipping(x + i, n - i, c, skip, &tailAbs);
+    *absSum = Sse2HorizontalSum(absLo, absHi) + tailAbs;
+    return squared;
+}
+
+//----------------------------------------------------------------------------------
+
+// Each AVX2 kernel works on 8 floats at a time, widened to two vectors of 4 doubles with an accumulator each,
+// and uses FMA where a product is added. The last n % 8 values go through the scalar kernel.
+
+__attribute__((target("avx2,fma")))
+static double Avx2HorizontalSum(__m256d a, __m256d b)
+{
+    __m256d both = _mm256_add_pd(a, b);
+    __m128d half = _mm_add_pd(_mm256_castpd256_pd128(both), _mm256_extractf128_pd(both, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+}
+
+//----------------------------------------------------------------------------------
+
+__attribute__((target("avx2,fma")))
+static int Avx2LaneTotal(__m256i counts)
+{
+    int lanes[8];
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), counts);
+    int total = 0;
+    for (int lane = 0; lane < 8; lane++)
+    {
+        total += lanes[lane];
+    }
+    return total;
+}
+
+//----------------------------------------------------------------------------------
+
+__attribute__((target("avx2,fma")))
+static double Avx2Sum(const float * x, int n)
+{
+    __m256d lo = _mm256_setzero_pd();
+    __m256d hi = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256 v = _mm256_loadu_ps(x + i);
+        lo = _mm256_add_pd(lo, _mm256_cvtps_pd(_mm256_castps256_ps128(v)));
+        hi = _mm256_add_pd(hi, _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)));
+    }
+    return Avx2HorizontalSum(lo, hi) + ScalarSum(x + i, n - i);
+}
+
+//----------------------------------------------------------------------------------
+
+__attribute__((target("avx2,fma")))
+static double Avx2SumSquaredDiff(const float * x, int n, float c)
+{
+    __m256 center = _mm256_set1_ps(c);
+    __m256d lo = _mm256_setzero_pd();
+    __m256d hi = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256 diff = _mm256_sub_ps(_mm256_loadu_ps(x + i), center);
+        __m256d dlo = _mm256_cvtps_pd(_mm256_castps256_ps128(diff));
+        __m256d dhi = _mm256_cvtps_pd(_mm256_extractf128_ps(diff, 1));
+        lo = _mm256_fmadd_pd(dlo, dlo, lo);
+        hi = _mm256_fmadd_pd(dhi, dhi, hi);
+    }
+    return Avx2HorizontalSum(lo, hi) + ScalarSumSquaredDiff(x + i, n - i, c);
+}
+
+//----------------------------------------------------------------------------------
+
+__attribute__((target("avx2,fma")))
+static double Avx2SumCrossDiff(const float * x, const float * y, int n, float cx, float cy)
+{
+    __m256 centerX = _mm256_set1_ps(cx);
+    __m256 centerY = _mm256_set1_ps(cy);
+    __m256d lo = _mm256_setzero_pd();
+    __m256d hi = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x + i), centerX);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y + i), centerY);
+        lo = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(dx)), _mm256_cvtps_pd(_mm256_castps256_ps128(dy)),
+                             lo);
+        hi = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(dx, 1)), _mm256_cvtps_pd(_mm256_extractf128_ps(dy, 1)),
+                             hi);
+    }
+    return Avx2HorizontalSum(lo, hi) + ScalarSumCrossDiff(x + i, y + i, n - i, cx, cy);
+}
+
+//----------------------------------------------------------------------------------
+
+__attribute__((target("avx2,fma")))
+static double Avx2SumAbsDiff(const float * x, int n, float c)
+{
+    __m256 center = _mm256_set1_ps(c);
+    __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(FLOAT_ABS_MASK));
+    __m256d lo = _mm256_setzero_pd();
+    __m256d hi = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256 diff = _mm256_and_ps(_mm256_sub_ps(_mm256_loadu_ps(x + i), center), absMask);
+        lo = _mm256_add_pd(lo, _mm256_cvtps_pd(_mm256_castps256_ps128(diff)));
+        hi = _mm256_add_pd(hi, _mm256_cvtps_pd(_mm256_extractf128_ps(diff, 1)));
+    }
+    return Avx2HorizontalSum(lo, hi) + ScalarSumAbsDiff(x + i, n - i, c);
+}
+
+//----------------------------------------------------------------------------------
+
+__attribute__((target("avx2,fma")))
+static double Avx2SumSkipping(const float * x, int n, float skip, int * count)
+{
+    __m256 skipped = _mm256_set1_ps(skip);
+    __m256d lo = _mm256_setzero_pd();
+    __m256d hi = _mm256_setzero_pd();
+    __m256i kept = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256 v = _mm256_loadu_ps(x + i);
+        __m256 keep = _mm256_cmp_ps(v, skipped, _CMP_NEQ_UQ);
+        __m256 masked = _mm256_and_ps(v, keep);
+        lo = _mm256_add_pd(lo, _mm256_cvtps_pd(_mm256_castps256_ps128(masked)));
+        hi = _mm256_add_pd(hi, _mm256_cvtps_pd(_mm256_extractf128_ps(masked, 1)));
+        kept = _mm256_sub_epi32(kept, _mm256_castps_si256(keep));
+    }
+
+    int tailCount = 0;
+    double sum = Avx2HorizontalSum(lo, hi) + ScalarSumSkipping(x + i, n - i, skip, &tailCount);
+    *count = Avx2LaneTotal(kept) + tailCount;
+    return sum;
+}
+
+//----------------------------------------------------------------------------------
+
+__attribute__((target("avx2,fma")))
+static double Avx2SumSquaredAbsDiffSkipping(const float * x, int n, float c, float skip, double * absSum)
+{
+    __m256 center = _mm256_set1_ps(c);
+    __m256 skipped = _mm256_set1_ps(skip);
+    __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(FLOAT_ABS_MASK));
+    __m256d squaredLo = _mm256_setzero_pd();
+    __m256d squaredHi = _mm256_setzero_pd();
+    __m256d absLo = _mm256_setzero_pd();
+    __m256d absHi = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256 v = _mm256_loadu_ps(x + i);
+        __m256 diff = _mm256_and_ps(_mm256_sub_ps(v, center), _mm256_cmp_ps(v, skipped, _CMP_NEQ_UQ));
+        __m256 absDiff = _mm256_and_ps(diff, absMask);
+        __m256d dlo = _mm256_cvtps_pd(_mm256_castps256_ps128(diff));
+        __m256d dhi = _mm256_cvtps_pd(_mm256_extractf128_ps(diff, 1));
+        squaredLo = _mm256_fmadd_pd(dlo, dlo, squaredLo);
+        squaredHi = _mm256_fmadd_pd(dhi, dhi, squaredHi);
+        absLo = _mm256_add_pd(absLo, _mm256_cvtps_pd(_mm256_castps256_ps128(absDiff)));
+        absHi = _mm256_add_pd(absHi, _mm256_cvtps_pd(_mm256_extractf128_ps(absDiff, 1)));
+    }
+
+    double tailAbs = 0;
+    double squared = Avx2HorizontalSum(squaredLo, squaredHi) +
+                     ScalarSumSquaredAbsDiffSkipping(x + i, n - i, c, skip, &tailAbs);
+    *absSum = Avx2HorizontalSum(absLo, absHi) + tailAbs;
+    return squared;
+}
+
+//----------------------------------------------------------------------------------
+
+#endif // FLOAT_KERNELS_X86
@@ -0,0 +1,110 @@
+#ifndef FLOATKERNELS_H
+#define FLOATKERNELS_H
+
+//----------------------------------------------------------------------------------
+
+/// The instruction sets a table of float kernels can be written for, from the most portable to the fastest.
+enum KernelLevel
+{
+    KERNEL_SCALAR, /// Plain C++ loops, available everywhere.
+    KERNEL_SSE2, /// 128-bit SSE2 vectors of four floats, available on every x86-64 processor.
+    KERNEL_AVX2 /// 256-bit AVX2 vectors of eight floats, on x86 processors that report AVX2 and FMA.
+};
+
+/// How a table of kernels combines its terms, from the fastest to the most accurate on long columns.
+///
+/// The compensated and pairwise policies add the terms of each SUMMATION_BLOCK values in the double lanes of the
+/// instruction set, and apply the policy to the block sums, so they cost one extra step per block rather than per
+/// value and keep the vector loops unchanged.
+enum SummationPolicy
+{
+    SUMMATION_DOUBLE, /// One running double sum per lane, whose error grows with the number of values.
+    SUMMATION_NEUMAIER, /// Block sums added with Neumaier's compensated summation.
+    SUMMATION_PAIRWISE /// Block sums added pairwise, as the leaves of a balanced binary tree.
+};
+
+/// The policy used by the float overloads in Calc.h when none is given.
+const SummationPolicy DEFAULT_SUMMATION = SUMMATION_PAIRWISE;
+
+/// The number of values each block of the compensated and pairwise policies covers.
+const int SUMMATION_BLOCK = 2048;
+
+/// A table of kernels over contiguous arrays of floats, all written for the same instruction set.
+///
+/// Every kernel reads x[0...n-1] (and y[0...n-1]) and accumulates in double precision whatever the instruction set,
+/// so the tables differ only in speed and in the order the values are added, which can change the last bits of a
+/// result. The kernels named Skipping leave out the values equal to skip, such as the -1.0f of a missing reading.
+/// sumSkipping and sumSquaredAbsDiffSkipping are the two passes of the fused statistics in Calc.h: the first stores
+/// the number of values it added in *count and gives the mean, the second both deviations around that mean.
+typedef struct {
+    KernelLevel level; /// The instruction set the kernels use.
+    SummationPolicy policy; /// How the kernels combine their terms.
+    const char * name; /// The name of the instruction set, for reports.
+    double (*sum)(const float * x, int n); /// Sum of x[i].
+    double (*sumSquaredDiff)(const float * x, int n, float c); /// Sum of (x[i] - c)^2.
+    double (*sumCrossDiff)(const float * x, const float * y, int n, float cx, float cy); /// Sum of (x[i] - cx)(y[i] - cy).
+    double (*sumAbsDiff)(const float * x, int n, float c); /// Sum of |x[i] - c|.
+    double (*sumSkipping)(const float * x, int n, float skip, int * count); /// Sum of x[i] != skip.
+    /// Sum of (x[i] - c)^2 over x[i] != skip, with the sum of |x[i] - c| stored in *absSum.
+    double (*sumSquaredAbsDiffSkipping)(const float * x, int n, float c, float skip, double * absSum);
+} FloatKernels;
+
+//----------------------------------------------------------------------------------
+
+    /**
+    * @brief Checks whether the processor running the program supports an instruction set.
+    *
+    * @param level - The instruction set to check.
+    * @return true if the kernels of that level can run on this processor.
+    * @pre None.
+    * @post None.
+    */
+bool IsKernelLevelSupported(KernelLevel level);
+
+    /**
+    * @brief Returns the fastest instruction set supported by the processor running the program.
+    *
+    * The processor is queried on the first call only.
+    *
+    * @return The highest supported KernelLevel.
+    * @pre None.
+    * @post None.
+    */
+KernelLevel GetBestKernelLevel();
+
+    /**
+    * @brief Returns the kernel table of an instruction set and summation policy.
+    *
+    * @param level - The instruction set.
+    * @param policy - How the kernels combine their terms.
+    * @return The table of kernels written for level that sum with policy.
+    * @pre IsKernelLevelSupported(level).
+    * @post None.
+    */
+const FloatKernels & GetFloatKernels(KernelLevel level, SummationPolicy policy = DEFAULT_SUMMATION);
+
+    /**
+    * @brief Returns the kernel table of the fastest instruction set the processor supports.
+    *
+    * Safe to call from several threads at once.
+    *
+    * @param policy - How the kernels combine their terms.
+    * @return The table of kernels for GetBestKernelLevel() that sum with policy.
+    * @pre None.
+    * @post None.
+    */
+const FloatKernels & GetBestFloatKernels(SummationPolicy policy = DEFAULT_SUMMATION);
+
+    /**
+    * @brief Returns the name of a summation policy, for reports.
+    *
+    * @param policy - The summation policy.
+    * @return "double", "Neumaier" or "pairwise".
+    * @pre None.
+    * @post None.
+    */
+const char * GetSummationPolicyName(SummationPolicy policy);
+
+//----------------------------------------------------------------------------------
+
+#endif // FLOATKERNELS_H
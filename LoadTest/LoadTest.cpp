@@ -0,0 +1,543 @@
+#include "../FileIO.h"
+#include "../AtmosCache.h"
+#include "../AtmosphereLogTypes.h"
+#include "../Vector.h"
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utime.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
+
+//---------------------------------------------------------------------------------------
+
+/// The small data files every loader is compared on. The test runs from the project folder, as the program does.
+const char * const SMALL_FILES[] = {"TestFile1.csv", "TestFile2.csv", "MetData-31-3a.csv", "MetData-31-3b.csv",
+                                    "MetData-31-3c.csv", "AllData.csv"};
+const int SMALL_FILE_COUNT = 6;
+
+/// A scratch file in data/, removed by every test that writes it.
+const char * const TEMP_NAME = "LoadTestTemp.csv";
+
+/// The scratch cache file and the source file it is stamped against, both in data/.
+const char * const CACHE_NAME = "LoadTestCache.bin";
+const char * const SOURCE_NAME = "LoadTestSource.csv";
+
+//---------------------------------------------------------------------------------------
+
+void TestOne();
+
+void TestTwo();
+
+void TestThree();
+
+void TestFour();
+
+void TestFive();
+
+void TestSix();
+
+void TestSeven();
+
+void TestEight();
+
+void TestNine();
+
+void TestTen();
+
+bool SaveTestCache(Vector<std::string> & filenames, AtmosLogType & records);
+
+bool CacheRejected(const Vector<std::string> & filenames);
+
+bool LoadAllWays(const std::string & filename, AtmosLogType & expected, LoadStatus & status);
+
+bool SameRecords(const AtmosLogType & a, const AtmosLogType & b);
+
+std::string ReadDataFile(const std::string & filename);
+
+void WriteDataFile(const std::string & filename, const std::string & contents);
+
+void RemoveDataFile(const std::string & filename);
+
+//---------------------------------------------------------------------------------------
+
+int main()
+{
+    std::cout << "Load Test\n";
+
+    std::cout << "Test One\n";
+    TestOne(); // The stream, mapped and chunked loaders agree on every small data file.
+    std::cout << std::endl;
+
+    std::cout << "Test Two\n";
+    TestTwo(); // CRLF line endings give the same records as LF.
+    std::cout << std::endl;
+
+    std::cout << "Test Three\n";
+    TestThree(); // A last row without a newline is still read.
+    std::cout << std::endl;
+
+    std::cout << "Test Four\n";
+    TestFour(); // An empty file, a header without rows, and a file that is not there.
+    std::cout << std::endl;
+
+    std::cout << "Test Five\n";
+    TestFive(); // ScanInt, ScanFloat and ParseDateTimeField on well-formed and malformed fields.
+    std::cout << std::endl;
+
+    std::cout << "Test Six\n";
+    TestSix(); // Records saved to the cache load back unchanged.
+    std::cout << std::endl;
+
+    std::cout << "Test Seven\n";
+    TestSeven(); // A cache with a bad checksum, version or magic number is rejected.
+    std::cout << std::endl;
+
+    std::cout << "Test Eight\n";
+    TestEight(); // A cache is rejected once a source file changes size or modification time.
+    std::cout << std::endl;
+
+    std::cout << "Test Nine\n";
+    TestNine(); // LoadAtmosphereData gives the same records in every ingest mode, without the cache.
+    std::cout << std::endl;
+
+    std::cout << "Test Ten\n";
+    TestTen(); // A source changed after it was parsed but before the cache was saved is parsed again.
+    std::cout << std::endl;
+
+    return 0;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestOne()
+{
+    for (int f = 0; f < SMALL_FILE_COUNT; f++)
+    {
+        AtmosLogType records;
+        LoadStatus status;
+        bool same = LoadAllWays(SMALL_FILES[f], records, status);
+        std::cout << SMALL_FILES[f] << ": " << records.GetSize() << " records, loaders agree: "
+                  << (same ? "yes" : "no") << std::endl;
+    }
+
+    // Any cut between rows must give the same records, which is what the chunked loader relies on
+    std::string contents = ReadDataFile("TestFile1.csv");
+    const char * begin = contents.data();
+    const char * end = begin + contents.size();
+    AtmosLogType whole;
+    ParseAtmosphereBuffer(begin, end, whole);
+
+    const char * rowsBegin;
+    int wastIndex, sIndex, tIndex, srIndex;
+    ParseBufferHeader(begin, end, rowsBegin, wastIndex, sIndex, tIndex, srIndex);
+    bool cuts = true;
+    for (const char * cut = rowsBegin; cut <= end; cut++)
+    {
+        if (cut != end && cut[-1] != '\n')
+        {
+            continue;
+        }
+        AtmosLogType pieces;
+        ParseAtmosphereRows(rowsBegin, cut, wastIndex, sIndex, tIndex, srIndex, pieces);
+        ParseAtmosphereRows(cut, end, wastIndex, sIndex, tIndex, srIndex, pieces);
+        cuts = cuts && SameRecords(whole, pieces);
+    }
+    std::cout << "Rows parsed in two pieces at every row boundary: " << (cuts ? "yes" : "no") << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestTwo()
+{
+    for (int f = 0; f < SMALL_FILE_COUNT; f++)
+    {
+        std::string lf = ReadDataFile(SMALL_FILES[f]);
+        std::string crlf;
+        for (std::size_t i = 0; i < lf.size(); i++)
+        {
+            if (lf[i] == '\n')
+            {
+                crlf += '\r';
+            }
+            crlf += lf[i];
+        }
+
+        AtmosLogType expected;
+        LoadStatus expectedStatus;
+        LoadAllWays(SMALL_FILES[f], expected, expectedStatus);
+
+        WriteDataFile(TEMP_NAME, crlf);
+        AtmosLogType records;
+        LoadStatus status;
+        bool same = LoadAllWays(TEMP_NAME, records, status) && status == expectedStatus &&
+                    SameRecords(expected, records);
+        RemoveDataFile(TEMP_NAME);
+        std::cout << SMALL_FILES[f] << " with CRLF line endings matches LF: " << (same ? "yes" : "no") << std::endl;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestThree()
+{
+    std::string contents = ReadDataFile("TestFile2.csv");
+    AtmosLogType expected;
+    LoadStatus expectedStatus;
+    LoadAllWays("TestFile2.csv", expected, expectedStatus);
+
+    std::string trimmed = contents;
+    while (!trimmed.empty() && trimmed[trimmed.size() - 1] == '\n')
+    {
+        trimmed.erase(trimmed.size() - 1);
+    }
+
+    WriteDataFile(TEMP_NAME, trimmed);
+    AtmosLogType records;
+    LoadStatus status;
+    bool same = LoadAllWays(TEMP_NAME, records, status) && SameRecords(expected, records);
+    std::cout << "No newline after the last row, every row read: " << (same ? "yes" : "no") << std::endl;
+
+    WriteDataFile(TEMP_NAME, trimmed + "\r");
+    AtmosLogType crRecords;
+    same = LoadAllWays(TEMP_NAME, crRecords, status) && SameRecords(expected, crRecords);
+    RemoveDataFile(TEMP_NAME);
+    std::cout << "Last row ending in a lone \\r, every row read: " << (same ? "yes" : "no") << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestFour()
+{
+    WriteDataFile(TEMP_NAME, "");
+    AtmosLogType empty;
+    LoadStatus status;
+    bool same = LoadAllWays(TEMP_NAME, empty, status);
+    RemoveDataFile(TEMP_NAME);
+    std::cout << "Empty file reported as missing columns with no records: "
+              << (same && status == LOAD_MISSING_COLUMNS && empty.GetSize() == 0 ? "yes" : "no") << std::endl;
+
+    AtmosLogType headerOnly;
+    same = LoadAllWays("TestFileEmpty.csv", headerOnly, status);
+    std::cout << "Header without rows loads with no records: "
+              << (same && status == LOAD_OK && headerOnly.GetSize() == 0 ? "yes" : "no") << std::endl;
+
+    AtmosLogType missing;
+    same = LoadAllWays("LoadTestMissing.csv", missing, status);
+    std::cout << "Missing file reported by every loader: "
+              << (same && status == LOAD_MISSING_FILE && missing.GetSize() == 0 ? "yes" : "no") << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestFive()
+{
+    const char * text = "2012x";
+    const char * p = text;
+    int value = 0;
+    bool scanned = ScanInt(p, text + 5, value) && value == 2012 && p == text + 4;
+    p = text + 4;
+    scanned = scanned && !ScanInt(p, text + 5, value) && p == text + 4;
+    std::cout << "ScanInt reads digits and stops at the first other character: " << (scanned ? "yes" : "no")
+              << std::endl;
+
+    const char * const numbers[] = {"26.42", "-12.75", " 4", "1.5e3", "0.1", "+7.", "123456789012345678901.5"};
+    const float expected[] = {26.42f, -12.75f, 4.0f, 1500.0f, 0.1f, 7.0f, 123456789012345678901.5f};
+    bool floats = true;
+    for (int i = 0; i < 7; i++)
+    {
+        const char * q = numbers[i];
+        float result = 0;
+        floats = floats && ScanFloat(q, numbers[i] + std::strlen(numbers[i]), result) && result == expected[i] &&
+                 q == numbers[i] + std::strlen(numbers[i]);
+    }
+    std::cout << "ScanFloat matches the nearest float: " << (floats ? "yes" : "no") << std::endl;
+
+    const char * const invalid[] = {"", "N/A", "-", ".", "e5"};
+    bool rejected = true;
+    for (int i = 0; i < 5; i++)
+    {
+        const char * q = invalid[i];
+        float result = 0;
+        rejected = rejected && !ScanFloat(q, invalid[i] + std::strlen(invalid[i]), result) && q == invalid[i];
+    }
+    std::cout << "ScanFloat rejects fields without digits: " << (rejected ? "yes" : "no") << std::endl;
+
+    const char * wast = "1/01/2012 11:50";
+    FieldView field = {wast, wast + std::strlen(wast)};
+    Date d;
+    MyTime t;
+    bool parsed = ParseDateTimeField(field, d, t) && d.GetDay() == 1 && d.GetMonth() == 1 && d.GetYear() == 2012 &&
+                  t.GetHour() == 11 && t.GetMinute() == 50;
+    std::cout << "ParseDateTimeField reads D/MM/YYYY H:MM: " << (parsed ? "yes" : "no") << std::endl;
+
+    const char * const malformed[] = {"", "1/01/2012", "1-01-2012 11:50", "1/01/2012 11", "x/01/2012 11:50"};
+    bool refused = true;
+    for (int i = 0; i < 5; i++)
+    {
+        FieldView bad = {malformed[i], malformed[i] + std::strlen(malformed[i])};
+        refused = refused && !ParseDateTimeField(bad, d, t);
+    }
+    std::cout << "ParseDateTimeField rejects malformed fields: " << (refused ? "yes" : "no") << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestSix()
+{
+    Vector<std::string> filenames;
+    AtmosLogType records;
+    bool saved = SaveTestCache(filenames, records);
+
+    AtmosLogType loaded;
+    LoadStatus fileStatus[2];
+    bool same = saved && LoadAtmosCache(std::string("data/") + CACHE_NAME, filenames, loaded, fileStatus) &&
+                SameRecords(records, loaded);
+    std::cout << records.GetSize() << " records, round trip through the cache: " << (same ? "yes" : "no")
+              << std::endl;
+    std::cout << "File statuses restored: "
+              << (same && fileStatus[0] == LOAD_OK && fileStatus[1] == LOAD_MISSING_FILE ? "yes" : "no") << std::endl;
+
+    // Loaded records are appended after what is already there
+    AtmosLogType appended;
+    appended.PushBack(records[0]);
+    same = LoadAtmosCache(std::string("data/") + CACHE_NAME, filenames, appended, fileStatus) &&
+           appended.GetSize() == records.GetSize() + 1;
+    std::cout << "Cached records appended to existing ones: " << (same ? "yes" : "no") << std::endl;
+
+    RemoveDataFile(CACHE_NAME);
+    RemoveDataFile(SOURCE_NAME);
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestSeven()
+{
+    Vector<std::string> filenames;
+    AtmosLogType records;
+    bool saved = SaveTestCache(filenames, records);
+    std::string cache = ReadDataFile(CACHE_NAME);
+
+    // The last byte belongs to the time keys, so only the checksum can catch the change
+    std::string corrupt = cache;
+    corrupt[corrupt.size() - 1] ^= 0x01;
+    WriteDataFile(CACHE_NAME, corrupt);
+    std::cout << "Changed payload byte rejected: " << (saved && CacheRejected(filenames) ? "yes" : "no")
+              << std::endl;
+
+    std::string version = cache;
+    version[offsetof(AtmosCacheHeader, version)] ^= 0x01;
+    WriteDataFile(CACHE_NAME, version);
+    std::cout << "Other version rejected: " << (saved && CacheRejected(filenames) ? "yes" : "no") << std::endl;
+
+    std::string magic = cache;
+    magic[offsetof(AtmosCacheHeader, magic)] = 'X';
+    WriteDataFile(CACHE_NAME, magic);
+    std::cout << "Other magic number rejected: " << (saved && CacheRejected(filenames) ? "yes" : "no") << std::endl;
+
+    WriteDataFile(CACHE_NAME, cache.substr(0, cache.size() - 1));
+    std::cout << "Truncated cache rejected: " << (saved && CacheRejected(filenames) ? "yes" : "no") << std::endl;
+
+    RemoveDataFile(CACHE_NAME);
+    RemoveDataFile(SOURCE_NAME);
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestEight()
+{
+    Vector<std::string> filenames;
+    AtmosLogType records;
+    bool saved = SaveTestCache(filenames, records);
+
+    std::string path = std::string("data/") + SOURCE_NAME;
+    FileStampType stamp;
+    GetFileStamp(path, stamp);
+    time_t seconds = static_cast<time_t>(stamp.mtime / 1000000000);
+
+    // Move the modification time back without touching the contents or the size
+    struct utimbuf times;
+    times.actime = seconds - 60;
+    times.modtime = seconds - 60;
+    bool touched = utime(path.c_str(), &times) == 0;
+    std::cout << "Source with another modification time rejected: "
+              << (saved && touched && CacheRejected(filenames) ? "yes" : "no") << std::endl;
+
+#ifndef _WIN32
+    // A rewrite of the same size within the same second only differs below the second
+    saved = SaveTestCache(filenames, records);
+    GetFileStamp(path, stamp);
+    struct timespec subsecond[2];
+    subsecond[0].tv_sec = 0;
+    subsecond[0].tv_nsec = UTIME_OMIT;
+    subsecond[1].tv_sec = static_cast<time_t>(stamp.mtime / 1000000000);
+    subsecond[1].tv_nsec = static_cast<long>((stamp.mtime % 1000000000 + 500000000) % 1000000000);
+    touched = utimensat(AT_FDCWD, path.c_str(), subsecond, 0) == 0;
+    std::cout << "Source changed within the same second rejected: "
+              << (saved && touched && CacheRejected(filenames) ? "yes" : "no") << std::endl;
+#endif
+
+    saved = SaveTestCache(filenames, records);
+    std::ofstream out(path.c_str(), std::ios::binary | std::ios::app);
+    out << "\n";
+    out.close();
+    std::cout << "Source with another size rejected: " << (saved && CacheRejected(filenames) ? "yes" : "no")
+              << std::endl;
+
+    // A file that was missing when the cache was written must still be missing
+    saved = SaveTestCache(filenames, records);
+    WriteDataFile(filenames[1], "");
+    std::cout << "Missing source that appeared rejected: " << (saved && CacheRejected(filenames) ? "yes" : "no")
+              << std::endl;
+
+    RemoveDataFile(filenames[1]);
+    RemoveDataFile(CACHE_NAME);
+    RemoveDataFile(SOURCE_NAME);
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestNine()
+{
+    // The files listed in data_source.txt include a missing one, whose warning is printed once per mode
+    const IngestMode modes[] = {INGEST_STREAM, INGEST_MAPPED, INGEST_PARALLEL, INGEST_CHUNKED};
+    const char * const names[] = {"stream", "mapped", "parallel", "chunked"};
+    AtmosLogType expected;
+    bool opened = LoadAtmosphereData(expected, INGEST_STREAM, false);
+    for (int m = 1; m < 4; m++)
+    {
+        AtmosLogType records;
+        bool same = opened && LoadAtmosphereData(records, modes[m], false) && SameRecords(expected, records);
+        std::cout << names[m] << " ingest matches stream, " << records.GetSize() << " records: "
+                  << (same ? "yes" : "no") << std::endl;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestTen()
+{
+    WriteDataFile(SOURCE_NAME, ReadDataFile("TestFile2.csv"));
+    Vector<std::string> filenames;
+    filenames.PushBack(SOURCE_NAME);
+
+    // The stamp is taken before parsing, as LoadAtmosphereData does, and a row is added before the save
+    FileStampType fileStamps[1];
+    GetFileStamp(std::string("data/") + SOURCE_NAME, fileStamps[0]);
+    AtmosLogType records;
+    LoadStatus fileStatus[1];
+    fileStatus[0] = LoadMappedFile(SOURCE_NAME, records, false);
+
+    std::string path = std::string("data/") + SOURCE_NAME;
+    std::ofstream out(path.c_str(), std::ios::binary | std::ios::app);
+    out << "\n1/02/2012 9:00,N/A,161,25,0.1,1006.7,1010.1,1010.3,0,50.4,4,567,29.7,27.6,27.5,26.2,7,26.42";
+    out.close();
+
+    bool saved = SaveAtmosCache(std::string("data/") + CACHE_NAME, filenames, fileStamps, fileStatus, records);
+    AtmosLogType loaded;
+    bool served = LoadAtmosCache(std::string("data/") + CACHE_NAME, filenames, loaded, fileStatus);
+    std::cout << "Cache written after the source changed is rejected: " << (saved && !served ? "yes" : "no")
+              << std::endl;
+
+    RemoveDataFile(CACHE_NAME);
+    RemoveDataFile(SOURCE_NAME);
+}
+
+//---------------------------------------------------------------------------------------
+
+bool SaveTestCache(Vector<std::string> & filenames, AtmosLogType & records)
+{
+    WriteDataFile(SOURCE_NAME, ReadDataFile("TestFile2.csv"));
+
+    filenames.Clear();
+    filenames.PushBack(SOURCE_NAME);
+    filenames.PushBack("LoadTestMissing.csv");
+    FileStampType fileStamps[2];
+    GetFileStamp(std::string("data/") + SOURCE_NAME, fileStamps[0]);
+    GetFileStamp("data/LoadTestMissing.csv", fileStamps[1]);
+    LoadStatus fileStatus[2];
+
+    records.Clear();
+    fileStatus[0] = LoadMappedFile(SOURCE_NAME, records, false);
+    fileStatus[1] = LoadMappedFile("LoadTestMissing.csv", records, false);
+    return fileStatus[0] == LOAD_OK && records.GetSize() > 0 &&
+           SaveAtmosCache(std::string("data/") + CACHE_NAME, filenames, fileStamps, fileStatus, records);
+}
+
+//---------------------------------------------------------------------------------------
+
+bool CacheRejected(const Vector<std::string> & filenames)
+{
+    AtmosLogType atmosData;
+    atmosData.PushBack(AtmosRecType());
+    LoadStatus fileStatus[2] = {LOAD_OK, LOAD_OK};
+    bool loaded = LoadAtmosCache(std::string("data/") + CACHE_NAME, filenames, atmosData, fileStatus);
+    return !loaded && atmosData.GetSize() == 1 && fileStatus[0] == LOAD_OK && fileStatus[1] == LOAD_OK;
+}
+
+//---------------------------------------------------------------------------------------
+
+bool LoadAllWays(const std::string & filename, AtmosLogType & expected, LoadStatus & status)
+{
+    AtmosLogType mapped;
+    AtmosLogType chunked;
+    status = LoadStreamFile(filename, expected);
+    LoadStatus mappedStatus = LoadMappedFile(filename, mapped, false);
+    LoadStatus chunkedStatus = LoadMappedFile(filename, chunked, true);
+    return status == mappedStatus && status == chunkedStatus && SameRecords(expected, mapped) &&
+           SameRecords(expected, chunked);
+}
+
+//---------------------------------------------------------------------------------------
+
+bool SameRecords(const AtmosLogType & a, const AtmosLogType & b)
+{
+    if (a.GetSize() != b.GetSize())
+    {
+        return false;
+    }
+    for (int i = 0; i < a.GetSize(); i++)
+    {
+        if (a[i].date.GetDay() != b[i].date.GetDay() || a[i].date.GetMonth() != b[i].date.GetMonth() ||
+            a[i].date.GetYear() != b[i].date.GetYear() || a[i].time.GetHour() != b[i].time.GetHour() ||
+            a[i].time.GetMinute() != b[i].time.GetMinute() || a[i].timestamp != b[i].timestamp ||
+            a[i].speed != b[i].speed || a[i].temperature != b[i].temperature || a[i].solar_rad != b[i].solar_rad)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+
+std::string ReadDataFile(const std::string & filename)
+{
+    std::ifstream in(("data/" + filename).c_str(), std::ios::binary);
+    std::ostringstream contents;
+    contents << in.rdbuf();
+    return contents.str();
+}
+
+//---------------------------------------------------------------------------------------
+
+void WriteDataFile(const std::string & filename, const std::string & contents)
+{
+    std::ofstream out(("data/" + filename).c_str(), std::ios::binary | std::ios::trunc);
+    out.write(contents.data(), contents.size());
+}
+
+//---------------------------------------------------------------------------------------
+
+void RemoveDataFile(const std::string & filename)
+{
+    std::remove(("data/" + filename).c_str());
+}
+
+//---------------------------------------------------------------------------------------
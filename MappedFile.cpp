@@ -0,0 +1,175 @@
+#include "MappedFile.h"
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+//----------------------------------------------------------------------------------
+
+MappedFile::MappedFile()
+{
+    m_data = nullptr;
+    m_size = 0;
+#ifdef _WIN32
+    m_file = INVALID_HANDLE_VALUE;
+    m_mapping = nullptr;
+#else
+    m_fd = -1;
+#endif
+}
+
+//----------------------------------------------------------------------------------
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+//----------------------------------------------------------------------------------
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::string & path)
+{
+    Close();
+
+    m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                         OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(m_file, &fileSize))
+    {
+        Close();
+        return false;
+    }
+
+    // Mapping a zero-length file fails, so an empty file is simply left unmapped
+    if (fileSize.QuadPart == 0)
+    {
+        return true;
+    }
+
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping == nullptr)
+    {
+        Close();
+        return false;
+    }
+
+    m_data = static_cast<const char *>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (m_data == nullptr)
+    {
+        Close();
+        return false;
+    }
+
+    m_size = static_cast<std::size_t>(fileSize.QuadPart);
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+
+void MappedFile::Close()
+{
+    if (m_data != nullptr)
+    {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping != nullptr)
+    {
+        CloseHandle(m_mapping);
+    }
+    if (m_file != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(m_file);
+    }
+
+    m_data = nullptr;
+    m_size = 0;
+    m_mapping = nullptr;
+    m_file = INVALID_HANDLE_VALUE;
+}
+
+#else
+
+bool MappedFile::Open(const std::string & path)
+{
+    Close();
+
+    m_fd = open(path.c_str(), O_RDONLY);
+    if (m_fd == -1)
+    {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(m_fd, &info) != 0)
+    {
+        Close();
+        return false;
+    }
+
+    // Mapping a zero-length file fails, so an empty file is simply left unmapped
+    if (info.st_size == 0)
+    {
+        return true;
+    }
+
+    void * view = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+    if (view == MAP_FAILED)
+    {
+        Close();
+        return false;
+    }
+    madvise(view, info.st_size, MADV_SEQUENTIAL);
+
+    m_data = static_cast<const char *>(view);
+    m_size = static_cast<std::size_t>(info.st_size);
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+
+void MappedFile::Close()
+{
+    if (m_data != nullptr)
+    {
+        munmap(const_cast<char *>(m_data), m_size);
+    }
+    if (m_fd != -1)
+    {
+        close(m_fd);
+    }
+
+    m_data = nullptr;
+    m_size = 0;
+    m_fd = -1;
+}
+
+#endif
+
+//----------------------------------------------------------------------------------
+
+const char * MappedFile::GetData() const
+{
+    return m_data;
+}
+
+//----------------------------------------------------------------------------------
+
+std::size_t MappedFile::GetSize() const
+{
+    return m_size;
+}
+
+//----------------------------------------------------------------------------------
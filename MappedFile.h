@@ -0,0 +1,107 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+//----------------------------------------------------------------------------------
+
+#include <string>
+#include <cstddef>
+
+//----------------------------------------------------------------------------------
+
+    /**
+    * @class MappedFile
+    * @brief A read-only memory mapping of an entire file.
+    *
+    * This class maps a file into the address space of the process so that its bytes can be read
+    * directly through a pointer, without copying them into std::string buffers. It uses
+    * CreateFileMapping/MapViewOfFile on Windows and mmap on POSIX systems. The mapping is released
+    * when the object is closed or destroyed. Objects of this class cannot be copied.
+    *
+    * @author agent
+    * @version 01
+    * @date 17/10/2026 agent, Started
+    *
+    * @todo Nothing
+    *
+    * @bug No bugs so far
+    */
+
+class MappedFile {
+public:
+    /**
+    * @brief Construct a MappedFile object.
+    *
+    * This constructor will construct a new object that does not map any file.
+    *
+    * @pre new object is initialized.
+    * @post a MappedFile object is created with no data and size set to 0.
+    */
+    MappedFile();
+
+    /**
+    * @brief Destructor for the MappedFile object.
+    *
+    * This destructor releases the mapping and closes the underlying file handle, if any.
+    *
+    * @pre the object is initialized.
+    * @post the mapping is released.
+    */
+    ~MappedFile();
+
+    /**
+    * @brief Map the file at the given path.
+    *
+    * Opens the file read-only and maps all of its bytes. Any previously mapped file is closed first.
+    * An empty file is opened successfully, with GetData() returning nullptr and GetSize() returning 0.
+    *
+    * @param path - the path of the file to map.
+    * @return true if the file was opened and mapped, false otherwise.
+    * @pre path is a valid file path.
+    * @post if successful, GetData() points to the file's bytes and GetSize() returns the file size.
+    */
+    bool Open(const std::string & path);
+
+    /**
+    * @brief Release the current mapping.
+    *
+    * @return void
+    * @pre None.
+    * @post No file is mapped, GetData() returns nullptr and GetSize() returns 0.
+    */
+    void Close();
+
+    /**
+    * @brief Returns a pointer to the first mapped byte.
+    *
+    * @return a pointer to the mapped bytes, or nullptr if no file (or an empty file) is mapped.
+    * @pre None.
+    * @post The object remains unchanged.
+    */
+    const char * GetData() const;
+
+    /**
+    * @brief Returns the number of mapped bytes.
+    *
+    * @return the size of the mapped file in bytes.
+    * @pre None.
+    * @post The object remains unchanged.
+    */
+    std::size_t GetSize() const;
+
+private:
+    const char * m_data; /// Pointer to the start of the mapped view
+    std::size_t m_size; /// Size of the mapped view in bytes
+#ifdef _WIN32
+    void * m_file; /// Windows file handle
+    void * m_mapping; /// Windows file mapping handle
+#else
+    int m_fd; /// POSIX file descriptor
+#endif
+
+    MappedFile(const MappedFile & other); /// Not copyable
+    MappedFile & operator=(const MappedFile & other); /// Not copyable
+};
+
+//----------------------------------------------------------------------------------
+
+#endif // MAPPEDFILE_H
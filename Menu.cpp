@@ -2,21 +2,35 @@
 #include "atmospherelogtypes.h"
 #include "calc.h"
 #include "vector.h"
-#include "BST.h"
-#include "Collector.h"
+#include "EytzingerIndex.h"
 #include "utils.h"
 #include "fileio.h"
+#include "Parallel.h"
 #include <map>
 #include <iostream>
 #include <iomanip>
+#include <sstream>
+#include <cmath>
 #include <string>
+#include <limits>
 
 //----------------------------------------------------------------------------------
 
-void RunMenuLoop(const BST<AtmosRecType> & atmos_bst, const std::map<int, AtmosLogType> & atmos_map)
+    /**
+    * @brief Recovers std::cin after a read that did not produce a number.
+    *
+    * @return false if the input has ended, true once the error is cleared and the rest of the line skipped.
+    * @pre A read from std::cin has just failed.
+    * @post If true is returned, std::cin is ready for the next prompt.
+    */
+static bool ClearFailedInput();
+
+//----------------------------------------------------------------------------------
+
+void RunMenuLoop(const EytzingerIndex<AtmosRecType> & atmos_index, const std::map<int, AtmosColumns> & atmos_map)
 {
     int choice = DisplayMenu();
-    while(choice != 5)
+    while(choice != 7)
     {
         switch(choice)
         {
@@ -29,13 +43,21 @@ void RunMenuLoop(const BST<AtmosRecType> & atmos_bst, const std::map<int, AtmosL
             std::cout << std::endl;
             break;
         case 3:
-            CalculateAndDisplaySPCC(atmos_bst);
+            CalculateAndDisplaySPCC(atmos_index, atmos_map);
             std::cout << std::endl;
             break;
         case 4:
             ExportToWindTempSolarCSV(atmos_map);
             std::cout << std::endl;
             break;
+        case 5:
+            DisplayTimeRangeStats(atmos_index);
+            std::cout << std::endl;
+            break;
+        case 6:
+            ExportAllYearsToCSV(atmos_map);
+            std::cout << std::endl;
+            break;
         default:
             std::cout << "Invalid option\n";
         }
@@ -51,7 +73,9 @@ int DisplayMenu()
     std::cout << "2. Air Temperature Average and Standard Deviation for Each Month in a Specified Year\n";
     std::cout << "3. Sample Pearson Correlation Coefficients for a Specified Month (Across All Years)\n";
     std::cout << "4. Export monthly Wind, Temperature & Solar Radiation stats for a Specified Year to WindTempSolar.csv\n";
-    std::cout << "5. Exit\n";
+    std::cout << "5. Wind, Temperature & Solar Radiation Stats Between Two Specified Dates and Times\n";
+    std::cout << "6. Export monthly Wind, Temperature & Solar Radiation stats for All Years to WindTempSolarAll.csv\n";
+    std::cout << "7. Exit\n";
     int choice;
     std::cout << "Option: ";
     std::cin >> choice;
@@ -61,26 +85,23 @@ int DisplayMenu()
 
 //----------------------------------------------------------------------------------
 
-void DisplayWindSpeedAvgAndStdDev(const std::map<int, AtmosLogType> & data)
+void DisplayWindSpeedAvgAndStdDev(const std::map<int, AtmosColumns> & data)
 {
     int month = PromptMonth();
     int year = PromptYear();
 
-    std::map<int, AtmosLogType>::const_iterator constItr = data.find(year);
+    std::map<int, AtmosColumns>::const_iterator constItr = data.find(year);
     if (constItr == data.end())
     {
         std::cout << MonthToString(month) << " " << year << ": No Data\n";
         return;
     }
-    const AtmosLogType & logOfYear = constItr->second;
+    const FieldSummary & speed = constItr->second.months[month - 1].speed;
 
-    Vector<float> speedVec;
-    GatherSpeedValues(logOfYear, speedVec, month);
-
-    if (speedVec.GetSize() > 0)
+    if (speed.count > 0)
     {
-        float mean = CalculateMean(speedVec, speedVec.GetSize());
-        float stddev = CalculateStandardDeviation(speedVec, speedVec.GetSize(), mean);
+        float mean = SummaryMean(speed);
+        float stddev = SummaryStandardDeviation(speed);
 
         std::cout << std::fixed << std::setprecision(1);
 
@@ -96,15 +117,14 @@ void DisplayWindSpeedAvgAndStdDev(const std::map<int, AtmosLogType> & data)
 
 //----------------------------------------------------------------------------------
 
-void DisplayTempAvgAndStdDev(const std::map<int, AtmosLogType> & data)
+void DisplayTempAvgAndStdDev(const std::map<int, AtmosColumns> & data)
 {
     int year = PromptYear();
-    Vector<float> tempVec;
     float mean, stddev;
 
     std::cout << year << std::endl;
 
-    std::map<int, AtmosLogType>::const_iterator constItr = data.find(year);
+    std::map<int, AtmosColumns>::const_iterator constItr = data.find(year);
     if (constItr == data.end())
     {
         for (int month = 1; month <= 12; month++)
@@ -113,20 +133,16 @@ void DisplayTempAvgAndStdDev(const std::map<int, AtmosLogType> & data)
         }
         return;
     }
-    const AtmosLogType & logOfYear = constItr->second;
+    const AtmosColumns & logOfYear = constItr->second;
 
     for (int month = 1; month <= 12; month++)
     {
-        mean = 0.0f;
-        stddev = 0.0f;
-        tempVec.Clear();
-
-        GatherTempValues(logOfYear, tempVec, month);
+        const FieldSummary & temp = logOfYear.months[month - 1].temperature;
 
-        if (tempVec.GetSize() > 0)
+        if (temp.count > 0)
         {
-            mean = CalculateMean(tempVec, tempVec.GetSize());
-            stddev = CalculateStandardDeviation(tempVec, tempVec.GetSize(), mean);
+            mean = SummaryMean(temp);
+            stddev = SummaryStandardDeviation(temp);
 
             std::cout << std::fixed << std::setprecision(1);
 
@@ -143,27 +159,46 @@ void DisplayTempAvgAndStdDev(const std::map<int, AtmosLogType> & data)
 
 //----------------------------------------------------------------------------------
 
-void CalculateAndDisplaySPCC(const BST<AtmosRecType> & data)
+void CalculateAndDisplaySPCC(const EytzingerIndex<AtmosRecType> & data, const std::map<int, AtmosColumns> & years)
 {
     int month = PromptMonth();
 
-    // Calculate ST
-    Collector::Clear();
-    Collector::SetTargetMonth(month);
-    data.InOrderTraversal(Collector::CollectST);
-    float st = sPCC(Collector::GetSpeedVec(), Collector::GetTempVec());
+    Vector<int> yearList;
+    for (std::map<int, AtmosColumns>::const_iterator itr = years.begin(); itr != years.end(); ++itr)
+    {
+        yearList.PushBack(itr->first);
+    }
+
+    // One pass over each year feeds all three pairs (ST, SR, TR). Years are accumulated concurrently and merged
+    // in year order, so the result does not depend on the number of threads.
+    int yearCount = yearList.GetSize();
+    PearsonAccumulator * partial = new PearsonAccumulator[yearCount * 3];
+    ParallelFor(yearCount, [&](int y)
+    {
+        PearsonAccumulator * pairs = partial + y * 3;
+        for (int p = 0; p < 3; p++)
+        {
+            ResetPearson(pairs[p]);
+        }
+        AtmosRecType lo, hi;
+        MakeMonthBounds(yearList[y], month, lo, hi);
+        data.VisitRange(lo, hi, [pairs](const AtmosRecType & a) { AccumulateCorrelationPairs(a, pairs); });
+    });
 
-    // Calculate SR
-    Collector::Clear();
-    Collector::SetTargetMonth(month);
-    data.InOrderTraversal(Collector::CollectSR);
-    float sr = sPCC(Collector::GetSpeedVec(), Collector::GetRadVec());
+    PearsonAccumulator total[3];
+    for (int p = 0; p < 3; p++)
+    {
+        ResetPearson(total[p]);
+        for (int y = 0; y < yearCount; y++)
+        {
+            MergePearson(total[p], partial[y * 3 + p]);
+        }
+    }
+    delete[] partial;
 
-    // Calculate TR
-    Collector::Clear();
-    Collector::SetTargetMonth(month);
-    data.InOrderTraversal(Collector::CollectTR);
-    float tr = sPCC(Collector::GetTempVec(), Collector::GetRadVec());
+    float st = PearsonCoefficient(total[0]);
+    float sr = PearsonCoefficient(total[1]);
+    float tr = PearsonCoefficient(total[2]);
 
     std::cout << std::fixed << std::setprecision(2);
     std::cout << "Sample Pearson Correlation Coefficient for " << MonthToString(month) << std::endl;
@@ -174,12 +209,9 @@ void CalculateAndDisplaySPCC(const BST<AtmosRecType> & data)
 
 //----------------------------------------------------------------------------------
 
-void ExportToWindTempSolarCSV(const std::map<int, AtmosLogType> & data)
+void ExportToWindTempSolarCSV(const std::map<int, AtmosColumns> & data)
 {
     int year = PromptYear();
-    Vector<float> speedVec, tempVec, srVec;
-    float mean, stddev, total, mad;
-    bool dataPrinted = false;
 
     std::ofstream out("data/WindTempSolar.csv");
     if (!out)
@@ -188,80 +220,273 @@ void ExportToWindTempSolarCSV(const std::map<int, AtmosLogType> & data)
         return;
     }
 
-    out << year << std::endl;
+    std::string buffer = std::to_string(year) + "\n";
 
-    std::map<int, AtmosLogType>::const_iterator constItr = data.find(year);
+    std::map<int, AtmosColumns>::const_iterator constItr = data.find(year);
     if (constItr == data.end())
     {
-        out << "No Data\n";
+        buffer += "No Data\n";
+        out.write(buffer.data(), buffer.size());
         out.close();
         return;
     }
-    const AtmosLogType & logOfYear = constItr->second;
+    const AtmosColumns & logOfYear = constItr->second;
 
-    for (int month = 1; month <= 12; month++)
+    // Each month is formatted by its own task into its own line, so the file does not depend on which task
+    // finishes first
+    std::string lines[12];
+    ParallelFor(12, [&](int m) { FormatExportMonth(logOfYear, m + 1, lines[m]); });
+    AppendExportMonths(lines, buffer);
+
+    out.write(buffer.data(), buffer.size());
+    out.close();
+}
+
+//----------------------------------------------------------------------------------
+
+void ExportAllYearsToCSV(const std::map<int, AtmosColumns> & data)
+{
+    std::ofstream out("data/WindTempSolarAll.csv");
+    if (!out)
     {
-        mean = 0.0f;
-        stddev = 0.0f;
-        total = 0.0f;
-        mad = 0.0f;
-        speedVec.Clear();
-        tempVec.Clear();
-        srVec.Clear();
+        std::cout << "Unable to open outfile\n";
+        return;
+    }
 
-        GatherSpeedValues(logOfYear, speedVec, month);
-        GatherTempValues(logOfYear, tempVec, month);
-        GatherSolarRadValues(logOfYear, srVec, month);
+    Vector<const AtmosColumns *> years;
+    Vector<int> yearList;
+    Vector<std::string> blocks;
+    for (std::map<int, AtmosColumns>::const_iterator itr = data.begin(); itr != data.end(); ++itr)
+    {
+        yearList.PushBack(itr->first);
+        years.PushBack(&itr->second);
+        blocks.EmplaceBack();
+    }
 
-        if (speedVec.GetSize() > 0 || tempVec.GetSize() > 0 || srVec.GetSize() > 0)
+    // The years are spread across the workers, each formatting the twelve months of its year into its own block,
+    // and the blocks are joined in year order
+    int yearCount = yearList.GetSize();
+    ParallelFor(yearCount, [&](int y)
+    {
+        std::string lines[12];
+        for (int m = 0; m < 12; m++)
         {
-            dataPrinted = true;
+            FormatExportMonth(*years[y], m + 1, lines[m]);
+        }
+        blocks[y] = std::to_string(yearList[y]) + "\n";
+        AppendExportMonths(lines, blocks[y]);
+    });
 
-            out << std::fixed << std::setprecision(1);
-            out << MonthToString(month) << ",";
+    std::string buffer;
+    if (yearCount == 0)
+    {
+        buffer = "No Data\n";
+    }
+    else
+    {
+        std::size_t size = 0;
+        for (int y = 0; y < yearCount; y++)
+        {
+            size += blocks[y].size();
+        }
+        buffer.reserve(size);
+        for (int y = 0; y < yearCount; y++)
+        {
+            buffer += blocks[y];
+        }
+    }
 
-            if (speedVec.GetSize() > 0)
-            {
-                mean = CalculateMean(speedVec, speedVec.GetSize());
-                stddev = CalculateStandardDeviation(speedVec, speedVec.GetSize(), mean);
-                mad = MAD(speedVec, speedVec.GetSize());
-                out << (mean * 3.6f) << "(" << (stddev * 3.6f) << ", " << (mad * 3.6f) << "),";
-            }
-            else
-            {
-                out << ",";
-            }
+    out.write(buffer.data(), buffer.size());
+    out.close();
+}
 
-            if (tempVec.GetSize() > 0)
-            {
-                mean = CalculateMean(tempVec, tempVec.GetSize());
-                stddev = CalculateStandardDeviation(tempVec, tempVec.GetSize(), mean);
-                mad = MAD(tempVec, tempVec.GetSize());
-                out << mean << "(" << stddev << ", " << mad << "),";
-            }
-            else
-            {
-                out << ",";
-            }
+//----------------------------------------------------------------------------------
 
-            if (srVec.GetSize() > 0)
-            {
-                total = CalculateTotal(srVec, srVec.GetSize());
-                out << (total * (10.0f / 60.0f) / 1000.0f) << "\n";
-            }
-            else
-            {
-                out << "\n";
-            }
+void AppendExportMonths(const std::string * lines, std::string & buffer)
+{
+    std::size_t size = buffer.size();
+    for (int m = 0; m < 12; m++)
+    {
+        size += lines[m].size();
+    }
+    if (size == buffer.size())
+    {
+        buffer += "No Data\n";
+        return;
+    }
+
+    buffer.reserve(size);
+    for (int m = 0; m < 12; m++)
+    {
+        buffer += lines[m];
+    }
+}
+
+//----------------------------------------------------------------------------------
+
+void FormatExportMonth(const AtmosColumns & logOfYear, int month, std::string & line)
+{
+    const MonthSummary & summary = logOfYear.months[month - 1];
+    int begin = logOfYear.monthBegin[month - 1];
+    int end = logOfYear.monthBegin[month];
+
+    line.clear();
+    if (summary.speed.count == 0 && summary.temperature.count == 0 && summary.solar_rad.count == 0)
+    {
+        return;
+    }
+
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    out << MonthToString(month) << ",";
+
+    if (summary.speed.count > 0)
+    {
+        ColumnStats speed = CalculateColumnStats(logOfYear.speed, begin, end, -1.0f);
+        out << (speed.mean * 3.6f) << "(" << (speed.stddev * 3.6f) << ", " << (speed.mad * 3.6f) << "),";
+    }
+    else
+    {
+        out << ",";
+    }
+
+    if (summary.temperature.count > 0)
+    {
+        ColumnStats temp = CalculateColumnStats(logOfYear.temperature, begin, end, -1.0f);
+        out << temp.mean << "(" << temp.stddev << ", " << temp.mad << "),";
+    }
+    else
+    {
+        out << ",";
+    }
+
+    if (summary.solar_rad.count > 0)
+    {
+        float total = static_cast<float>(summary.solar_rad.sum);
+        out << (total * (10.0f / 60.0f) / 1000.0f) << "\n";
+    }
+    else
+    {
+        out << "\n";
+    }
+
+    line = out.str();
+}
+
+//----------------------------------------------------------------------------------
+
+void DisplayTimeRangeStats(const EytzingerIndex<AtmosRecType> & data)
+{
+    Date startDate, endDate;
+    MyTime startTime, endTime;
+    PromptDateTime("start", startDate, startTime);
+    PromptDateTime("end", endDate, endTime);
+
+    AtmosRecType lo = MakeRangeBound(MakeTimestamp(startDate, startTime), false);
+    AtmosRecType hi = MakeRangeBound(MakeTimestamp(endDate, endTime), true);
+
+    // Two passes over the range feed the fused statistics straight from the records, so no values are copied
+    ColumnStatsAccumulator speedAcc, tempAcc;
+    ResetColumnStats(speedAcc);
+    ResetColumnStats(tempAcc);
+    double srTotal = 0;
+    int srCount = 0;
+    data.VisitRange(lo, hi, [&](const AtmosRecType & a)
+    {
+        if (a.speed != -1.0f)
+        {
+            AddToMeanPass(speedAcc, a.speed);
+        }
+        if (a.temperature != -1.0f)
+        {
+            AddToMeanPass(tempAcc, a.temperature);
+        }
+        if (a.solar_rad >= 100.0f)
+        {
+            srTotal += a.solar_rad;
+            srCount++;
         }
+    });
+    FinishMeanPass(speedAcc);
+    FinishMeanPass(tempAcc);
+    data.VisitRange(lo, hi, [&](const AtmosRecType & a)
+    {
+        if (a.speed != -1.0f)
+        {
+            AddToDeviationPass(speedAcc, a.speed);
+        }
+        if (a.temperature != -1.0f)
+        {
+            AddToDeviationPass(tempAcc, a.temperature);
+        }
+    });
+    ColumnStats speed = GetColumnStats(speedAcc);
+    ColumnStats temp = GetColumnStats(tempAcc);
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << startDate << " " << startTime.GetHour() << ":" << std::setw(2) << std::setfill('0')
+              << startTime.GetMinute() << std::setfill(' ') << " to " << endDate << " " << endTime.GetHour()
+              << ":" << std::setw(2) << std::setfill('0') << endTime.GetMinute() << std::setfill(' ') << ":\n";
+
+    if (speed.count > 0)
+    {
+        std::cout << "Average Speed: " << (speed.mean * 3.6f) << " km/h, stddev: " << (speed.stddev * 3.6f) << "\n";
+    }
+    else
+    {
+        std::cout << "Wind Speed: No Data\n";
     }
 
-    if (!dataPrinted)
+    if (temp.count > 0)
+    {
+        std::cout << "Average Temperature: " << temp.mean << " degrees C, stddev: " << temp.stddev << "\n";
+    }
+    else
     {
-        out << "No Data\n";
+        std::cout << "Air Temperature: No Data\n";
     }
 
-    out.close();
+    if (srCount > 0)
+    {
+        float total = static_cast<float>(srTotal);
+        std::cout << "Total Solar Radiation: " << (total * (10.0f / 60.0f) / 1000.0f) << " kWh/m^2\n";
+    }
+    else
+    {
+        std::cout << "Solar Radiation: No Data\n";
+    }
+}
+
+//----------------------------------------------------------------------------------
+
+void MakeMonthBounds(int year, int month, AtmosRecType & lo, AtmosRecType & hi)
+{
+    Date first(1, month, year);
+    Date last(31, month, year);
+    lo = MakeRangeBound(MakeTimestamp(first, MyTime(0, 0)), false);
+    hi = MakeRangeBound(MakeTimestamp(last, MyTime(23, 59)), true);
+}
+
+//----------------------------------------------------------------------------------
+
+void AccumulateCorrelationPairs(const AtmosRecType & a, PearsonAccumulator * pairs)
+{
+    bool hasSpeed = (a.speed != -1.0f);
+    bool hasTemp = (a.temperature != -1.0f);
+    bool hasRad = (a.solar_rad >= 100.0f);
+
+    if (hasSpeed && hasTemp)
+    {
+        AddPearsonPair(pairs[0], a.speed, a.temperature);
+    }
+    if (hasSpeed && hasRad)
+    {
+        AddPearsonPair(pairs[1], a.speed, a.solar_rad);
+    }
+    if (hasTemp && hasRad)
+    {
+        AddPearsonPair(pairs[2], a.temperature, a.solar_rad);
+    }
 }
 
 //----------------------------------------------------------------------------------
@@ -290,70 +515,90 @@ int PromptMonth()
 
 //----------------------------------------------------------------------------------
 
-int PromptYear()
+void PromptDateTime(const std::string & label, Date & d, MyTime & t)
 {
-    int y;
-
-    std::cout << "Enter the year: ";
-    std::cin >> y;
-
-    return y;
-}
-
-//----------------------------------------------------------------------------------
+    int day = -1, month = -1, year = -1;
+    int hour = -1, minute = -1;
+    bool valid = false;
 
-static const std::string & MonthToString(int monthNum)
-{
-    static const std::string invalid = "Invalid Month";
-    static const std::string months[12] = {"January", "February", "March", "April", "May", "June",
-                                           "July", "August", "September", "October", "November", "December"};
-    if (monthNum >= 1 && monthNum <= 12)
+    while (!valid)
     {
-        return months[monthNum - 1];
+        std::cout << "Enter the " << label << " date (dd mm yyyy): ";
+        std::cin >> day >> month >> year;
+        if (!std::cin)
+        {
+            if (!ClearFailedInput())
+            {
+                return;
+            }
+            continue;
+        }
+        valid = day >= 1 && day <= 31 && month >= 1 && month <= 12 && year >= 0 && year <= MAX_TIMESTAMP_YEAR;
     }
-    else
+
+    valid = false;
+    while (!valid)
     {
-        return invalid;
+        std::cout << "Enter the " << label << " time (hh mm): ";
+        std::cin >> hour >> minute;
+        if (!std::cin)
+        {
+            if (!ClearFailedInput())
+            {
+                return;
+            }
+            continue;
+        }
+        valid = hour >= 0 && hour <= 23 && minute >= 0 && minute <= 59;
     }
+
+    d = Date(day, month, year);
+    t = MyTime(hour, minute);
 }
 
 //----------------------------------------------------------------------------------
 
-void GatherSpeedValues(const AtmosLogType & source, Vector<float> & vec, int month)
+static bool ClearFailedInput()
 {
-    for (int i = 0; i < source.GetSize(); i++)
+    // Nothing more can be read once the input has ended, so the caller must stop prompting
+    if (std::cin.eof())
     {
-        if (source[i].date.GetMonth() == month && source[i].speed != -1.0f)
-        {
-            vec.PushBack(source[i].speed);
-        }
+        return false;
     }
+
+    // Drop the rest of the line that could not be read as numbers, so the next prompt starts afresh
+    std::cin.clear();
+    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    return true;
 }
 
 //----------------------------------------------------------------------------------
 
-void GatherTempValues(const AtmosLogType & source, Vector<float> & vec, int month)
+int PromptYear()
 {
-    for (int i = 0; i < source.GetSize(); i++)
-    {
-        if (source[i].date.GetMonth() == month && source[i].temperature != -1.0f)
-        {
-            vec.PushBack(source[i].temperature);
-        }
-    }
+    int y;
+
+    std::cout << "Enter the year: ";
+    std::cin >> y;
+
+    return y;
 }
 
 //----------------------------------------------------------------------------------
 
-void GatherSolarRadValues(const AtmosLogType & source, Vector<float> & vec, int month)
+static const std::string & MonthToString(int monthNum)
 {
-    for (int i = 0; i < source.GetSize(); i++)
+    static const std::string invalid = "Invalid Month";
+    static const std::string months[12] = {"January", "February", "March", "April", "May", "June",
+                                           "July", "August", "September", "October", "November", "December"};
+    if (monthNum >= 1 && monthNum <= 12)
     {
-        if (source[i].date.GetMonth() == month && source[i].solar_rad >= 100.0f)
-        {
-            vec.PushBack(source[i].solar_rad);
-        }
+        return months[monthNum - 1];
+    }
+    else
+    {
+        return invalid;
     }
 }
 
-//----------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------
\ No newline at end of file
@@ -4,7 +4,8 @@
 //----------------------------------------------------------------------------------
 
 #include "atmospherelogtypes.h"
-#include "BST.h"
+#include "calc.h"
+#include "EytzingerIndex.h"
 #include <map>
 #include <string>
 
@@ -15,50 +16,51 @@
     *
     * Handles the menu loop after displaying the menu, and runs the method associated with the user's menu choice.
     *
-    * @param atmos_bst - A BST containing the atmospheric data.
-    * @param atmos_map - An std::map containing the atmospheric data, keyed by years as integers.
+    * @param atmos_index - A frozen search index containing the atmospheric data.
+    * @param atmos_map - An std::map containing the columnar atmospheric data, keyed by years as integers.
     * @return void
     * @pre Assumes user will enter a valid integer.
     * @post Calls the method associated with the menu choice.
     */
-void RunMenuLoop(const BST<AtmosRecType> & atmos_bst, const std::map<int, AtmosLogType> & atmos_map);
+void RunMenuLoop(const EytzingerIndex<AtmosRecType> & atmos_index, const std::map<int, AtmosColumns> & atmos_map);
 
     /**
     * @brief Displays the main menu and prompts the user for a selection.
     *
-    * Provides the user with options 1 through 5 in a menu format, and reads an integer input.
+    * Provides the user with options 1 through 7 in a menu format, and reads an integer input.
     *
     * @return int - the option selected by the user.
     * @pre Assumes user will enter a valid integer.
-    * @post Returns a value between 1 and 5.
+    * @post Returns a value between 1 and 7.
     */
 int DisplayMenu();
 
     /**
     * @brief Display wind speed average and standard deviation.
     *
-    * Prompts user for month and year, then gathers wind speed values for that time period.
-    * If data is found, calculates average and standard deviation, and displays them.
+    * Prompts user for month and year, then looks up the wind speed summary of that month.
+    * If data is found, derives the average and standard deviation from it, and displays them.
     *
-    * @param data - An std::map containing the atmospheric data, keyed by years as integers.
+    * @param data - An std::map containing the columnar atmospheric data, keyed by years as integers.
     * @return void
     * @pre Assumes user inputs valid month and year.
     * @post Outputs statistics or "No Data" message.
     */
-void DisplayWindSpeedAvgAndStdDev(const std::map<int, AtmosLogType> & data);
+void DisplayWindSpeedAvgAndStdDev(const std::map<int, AtmosColumns> & data);
 
     /**
     * @brief Display temperature average and stddev for each month of a given year.
     *
     * Iterates through all the months of a year (prompted from the user) and prints the average temperature
-    * and standard deviation values for each month, or "No Data" if month does not contain any data.
+    * and standard deviation values for each month, taken from the month summaries, or "No Data" if month does not
+    * contain any data.
     *
-    * @param data - An std::map containing the atmospheric data, keyed by years as integers.
+    * @param data - An std::map containing the columnar atmospheric data, keyed by years as integers.
     * @return void
     * @pre Assumes valid integer year.
     * @post Displays per-month statistics or "No Data".
     */
-void DisplayTempAvgAndStdDev(const std::map<int, AtmosLogType> & data);
+void DisplayTempAvgAndStdDev(const std::map<int, AtmosColumns> & data);
 
     /**
     * @brief Calculates and displays Sample Pearson Correlation Coefficients for a specified month.
@@ -68,30 +70,118 @@ void DisplayTempAvgAndStdDev(const std::map<int, AtmosLogType> & data);
     * - Wind Speed vs Solar Radiation (S_R)
     * - Air Temperature vs Solar Radiation (T_R)
     *
-    * It uses the static `Collector` class to gather filtered data from the provided BST of atmospheric records.
-    * Data is collected via in-order traversal using function pointers to Collector methods. Each correlation
-    * coefficient is then computed using the `sPCC` methods and printed to the console.
+    * The records of the month are visited once per loaded year with a range query, so records of other months are
+    * not visited. Each record feeds a streaming PearsonAccumulator for every pair it is valid for, so no values are
+    * stored. Years are accumulated concurrently, merged in year order, and the coefficients printed to the console.
     *
-    * @param data A constant reference to a BST of AtmosRecType records, representing all atmospheric data.
+    * @param data A constant reference to a search index of AtmosRecType records, representing all atmospheric data.
+    * @param years An std::map keyed by every year present in data.
     * @return void
-    * @pre The BST must be populated with valid AtmosRecType data. The Collector class must be correctly implemented.
-    * @post No changes to the BST. Output is printed to standard output. Collectors internal state is reset between each correlation.
+    * @pre The index must be populated with valid AtmosRecType data.
+    * @post No changes to the index. Output is printed to standard output.
     */
-void CalculateAndDisplaySPCC(const BST<AtmosRecType> & data);
+void CalculateAndDisplaySPCC(const EytzingerIndex<AtmosRecType> & data, const std::map<int, AtmosColumns> & years);
 
     /**
     * @brief Export wind, temperature, and solar radiation data to file.
     *
     * Writes formatted output of mean for speed and temperature, standard deviation for speed and temperature to
     * WindTempSolar.csv for a given year (prompted from the user). Skips months with no data. If the year has no data at all,
-    * writes "No Data" instead.
+    * writes "No Data" instead. The twelve lines are formatted by FormatExportMonth as parallel tasks, joined in
+    * month order into one buffer sized to fit them, and written to the file with a single call.
     *
-    * @param data - An std::map containing the atmospheric data, keyed by years as integers.
+    * @param data - An std::map containing the columnar atmospheric data, keyed by years as integers.
     * @return void
     * @pre Assumes data is correctly read and year input is valid.
     * @post Outputs a CSV file with atmosphere statistics or "No Data" in the second line.
     */
-void ExportToWindTempSolarCSV(const std::map<int, AtmosLogType> & data);
+void ExportToWindTempSolarCSV(const std::map<int, AtmosColumns> & data);
+
+    /**
+    * @brief Formats the line of one month of the WindTempSolar.csv export.
+    *
+    * The mean, standard deviation and MAD of wind speed and air temperature come from CalculateColumnStats, which
+    * reads the month's column range twice, and the solar total comes from the month summary. Reads logOfYear only,
+    * so the months of a year can be formatted by different threads at the same time.
+    *
+    * @param logOfYear - The columnar data of one year.
+    * @param month - The month (1-12).
+    * @param line - Set to the month's line including its newline, or to an empty string if the month has no data.
+    * @return void
+    * @pre 1 <= month <= 12.
+    * @post logOfYear is unchanged.
+    */
+void FormatExportMonth(const AtmosColumns & logOfYear, int month, std::string & line);
+
+    /**
+    * @brief Export wind, temperature, and solar radiation data of every year to file.
+    *
+    * Writes the block ExportToWindTempSolarCSV would write for each year in data to WindTempSolarAll.csv, one after
+    * another in year order, or "No Data" if data is empty. The map is walked once, the years are formatted as
+    * parallel tasks that each read only their own year, and the blocks are joined into one buffer written to the
+    * file with a single call.
+    *
+    * @param data - An std::map containing the columnar atmospheric data, keyed by years as integers.
+    * @return void
+    * @pre Assumes data is correctly read.
+    * @post Outputs a CSV file with the atmosphere statistics of every year.
+    */
+void ExportAllYearsToCSV(const std::map<int, AtmosColumns> & data);
+
+    /**
+    * @brief Appends the month lines of one year of the export to a buffer.
+    *
+    * @param lines - An array of twelve lines made by FormatExportMonth, for January to December.
+    * @param buffer - The buffer to append to, reserved once to the size of the lines.
+    * @return void
+    * @pre None.
+    * @post The non-empty lines have been appended in month order, or "No Data" if every line is empty.
+    */
+void AppendExportMonths(const std::string * lines, std::string & buffer);
+
+    /**
+    * @brief Display wind speed, temperature and solar radiation statistics between two dates and times.
+    *
+    * Prompts the user for a start and an end date and time, and visits every record in that closed range twice with
+    * EytzingerIndex::VisitRange, feeding the two passes of a ColumnStatsAccumulator, so only the records in the
+    * range are visited and no values are copied. Prints the average and standard deviation of wind speed and air
+    * temperature, and the total solar radiation, or "No Data" for each measurement without valid values.
+    *
+    * @param data - A search index containing the atmospheric data.
+    * @return void
+    * @pre Assumes user inputs valid integers.
+    * @post Outputs statistics or "No Data" messages.
+    */
+void DisplayTimeRangeStats(const EytzingerIndex<AtmosRecType> & data);
+
+    /**
+    * @brief Makes the bounds of a range query covering one month of one year.
+    *
+    * Passing lo and hi to EytzingerIndex::VisitRange visits every record of the month in chronological order.
+    *
+    * @param year - The year of the month.
+    * @param month - The month (1-12).
+    * @param lo - Set to a bound below every record of the month.
+    * @param hi - Set to a bound above every record of the month.
+    * @return void
+    * @pre 1 <= month <= 12.
+    * @post No record outside the month lies in [lo, hi], and every record of the month does.
+    */
+void MakeMonthBounds(int year, int month, AtmosRecType & lo, AtmosRecType & hi);
+
+    /**
+    * @brief Adds a record to the correlation accumulators of the pairs it is valid for.
+    *
+    * A pair is valid if neither of its values is filtered out: speed and temperature must not be -1 (missing),
+    * and solar radiation must be at least 100 W/m^2.
+    *
+    * @param a - The record to add.
+    * @param pairs - An array of three PearsonAccumulator objects, for S_T, S_R and T_R in that order.
+    * @return void
+    * @pre The three accumulators have been reset.
+    * @post Each accumulator whose pair is valid in a has one more pair.
+    */
+void AccumulateCorrelationPairs(const AtmosRecType & a, PearsonAccumulator * pairs);
 
     /**
     * @brief Prints the date and time from a given AtmosRecType record.
@@ -115,6 +205,23 @@ void PrintDateAndTime(const AtmosRecType & a);
     */
 int PromptMonth();
 
+    /**
+    * @brief Prompts the user to enter a date and a time.
+    *
+    * Prompts for the day, month and year, then the hour and minute, as space-separated integers. Each prompt
+    * loops until the values are in range, and an entry that is not a number is discarded before prompting again.
+    * Years above MAX_TIMESTAMP_YEAR are refused, as MakeTimestamp() cannot pack them.
+    *
+    * @param label - A word describing the date, such as "start", inserted into the prompts.
+    * @param d - Output parameter for the entered date.
+    * @param t - Output parameter for the entered time.
+    * @return void
+    * @pre Function is called in a valid context, ie. in main() or any other function.
+    * @post d holds a date with day 1-31, month 1-12 and year 0-MAX_TIMESTAMP_YEAR, and t holds a valid 24-hour
+    *       time. If the input ends first, d and t are left unchanged.
+    */
+void PromptDateTime(const std::string & label, Date & d, MyTime & t);
+
     /**
     * @brief Prompts the user to enter a year.
     *
@@ -138,46 +245,6 @@ int PromptYear();
     */
 static const std::string & MonthToString(int monthNum);
 
-    /**
-    * @brief Gathers wind speed values for a specified month.
-    *
-    * Gathers wind speed values for a specific month from an atmospheric record vector.
-    *
-    * @param source - Const Reference to Atmospheric record vector.
-    * @param vec - Reference to Vector to store speed values.
-    * @param month - The month to filter data.
-    * @pre source must contain valid atmospheric records.
-    * @post vec will be populated with valid speed values.
-    */
-void GatherSpeedValues(const AtmosLogType & source, Vector<float> & vec, int month);
-
-    /**
-    * @brief Gathers air temperature values for a specific month.
-    *
-    * Gathers air temperature values for a specific month from an atmospheric record vector.
-    *
-    * @param source - Const Reference to Atmospheric record vector.
-    * @param vec - Reference to Vector to store speed values.
-    * @param month - The month to filter data.
-    * @pre source must contain valid atmospheric records.
-    * @post vec will be populated with valid temperature values.
-    */
-void GatherTempValues(const AtmosLogType & source, Vector<float> & vec, int month);
-
-    /**
-    * @brief Gathers solar radiation values for a specific year and optional month.
-    *
-    * Gathers solar radiation values for a specific month from an atmospheric record vector.
-    * Does not gather solar radiation values below 100 W/m^2.
-    *
-    * @param source - Const Reference to Atmospheric record vector.
-    * @param vec - Reference to Vector to store speed values.
-    * @param month - The month to filter data.
-    * @pre source must contain valid atmospheric records.
-    * @post vec will be populated with valid solar radiation values.
-    */
-void GatherSolarRadValues(const AtmosLogType & source, Vector<float> & vec, int month);
-
 //----------------------------------------------------------------------------------
 
 #endif // MENU_H
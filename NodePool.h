@@ -0,0 +1,314 @@
+#ifndef NODEPOOL_H
+#define NODEPOOL_H
+
+//---------------------------------------------------------------------------------------
+
+#include "Vector.h"
+#include <new>
+
+//---------------------------------------------------------------------------------------
+
+/// A chunk of uninitialised storage from which a NodePool hands out slots.
+template <class T>
+struct Slab
+{
+    T * items; /// The first slot of the slab.
+    int capacity; /// The number of slots in the slab.
+    int used; /// The number of slots handed out so far, always the first used slots.
+};
+
+//---------------------------------------------------------------------------------------
+
+    /**
+    * @class NodePool
+    * @brief A slab allocator handing out storage for objects of one type.
+    *
+    * Slots are taken in order from large slabs of raw storage instead of being allocated one at a time, so
+    * neighbouring allocations are close together in memory and n allocations cost O(log n) calls to the heap.
+    * Each new slab is twice the size of the last, up to POOL_MAX_SLAB slots. Freed slots are kept on a free list
+    * and reused before new slots are taken. Release() returns every slab to the heap at once. A freed slot stores the
+    * link to the next freed slot in its own storage, so T must be at least as large as a pointer.
+    *
+    * The pool only manages storage: the caller constructs objects in the slots with placement new, and must
+    * destroy them before freeing or releasing the slots.
+    *
+    * @author agent
+    * @version 01
+    * @date 17/10/2026 agent, Started
+    *
+    * @todo Nothing
+    *
+    * @bug No bugs so far
+    */
+
+//---------------------------------------------------------------------------------------
+
+/// The number of slots in the first slab of a NodePool.
+const int POOL_FIRST_SLAB = 32;
+
+/// The largest number of slots a NodePool adds in one slab when growing one slot at a time.
+const int POOL_MAX_SLAB = 65536;
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+class NodePool
+{
+    static_assert(sizeof(T) >= sizeof(T *), "NodePool slots must be large enough to hold a free-list link");
+
+public:
+    /**
+    * @brief Construct an empty NodePool object.
+    *
+    * @pre None.
+    * @post The pool holds no slabs.
+    */
+    NodePool();
+
+    /**
+    * @brief Destructor for the NodePool object.
+    *
+    * @pre Every object constructed in the pool has been destroyed.
+    * @post All slabs are returned to the heap.
+    */
+    ~NodePool();
+
+    NodePool(const NodePool<T> & other) = delete;
+
+    NodePool<T> & operator=(const NodePool<T> & other) = delete;
+
+    /**
+    * @brief Take storage for one object.
+    *
+    * @return A pointer to uninitialised storage for one T.
+    * @pre None.
+    * @post The slot is owned by the caller until it is freed or the pool is released.
+    */
+    T * Allocate();
+
+    /**
+    * @brief Take storage for n objects in one contiguous run.
+    *
+    * @param n - The number of slots.
+    * @return A pointer to uninitialised storage for n consecutive T, or nullptr if n is 0.
+    * @pre n >= 0.
+    * @post The slots are owned by the caller until they are freed or the pool is released.
+    */
+    T * AllocateBlock(int n);
+
+    /**
+    * @brief Return one slot to the pool to be reused by Allocate().
+    *
+    * @param item - A slot returned by Allocate() or AllocateBlock().
+    * @return void
+    * @pre The object in the slot has been destroyed.
+    * @post The slot is on the free list.
+    */
+    void Free(T * item);
+
+    /**
+    * @brief Make sure the next n slots can be taken from one slab.
+    *
+    * @param n - The number of slots about to be allocated.
+    * @return void
+    * @pre n >= 0.
+    * @post The current slab has at least n unused slots.
+    */
+    void Reserve(int n);
+
+    /**
+    * @brief Return every slab to the heap at once.
+    *
+    * @return void
+    * @pre Every object constructed in the pool has been destroyed.
+    * @post The pool holds no slabs, and every slot it handed out is invalid.
+    */
+    void Release();
+
+    /**
+    * @brief Check whether every slot handed out is in use and lies in one slab.
+    *
+    * @return true if the pool has a single slab and an empty free list.
+    * @pre None.
+    * @post The pool remains unchanged.
+    */
+    bool IsContiguous() const;
+
+    /**
+    * @brief Return the first slot of the first slab.
+    *
+    * @return The first slot, or nullptr if the pool holds no slabs.
+    * @pre None.
+    * @post The pool remains unchanged.
+    */
+    T * GetFirstSlot() const;
+
+    /**
+    * @brief Return the number of slots handed out and not freed.
+    *
+    * @return The number of slots in use.
+    * @pre None.
+    * @post The pool remains unchanged.
+    */
+    int GetUsed() const;
+
+private:
+    Vector<Slab<T> > m_slabs; /// The slabs, with the one slots are taken from last.
+    T * m_freeHead; /// The most recently freed slot, whose storage holds the next freed slot, or nullptr.
+    int m_used; /// The number of slots handed out and not freed.
+
+    /**
+    * @brief Add a new slab with the given number of slots and make it the current slab.
+    *
+    * @param capacity - The number of slots in the slab.
+    * @return void
+    * @pre capacity > 0.
+    * @post The last slab in m_slabs has capacity slots, none of them used.
+    */
+    void AddSlab(int capacity);
+};
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+NodePool<T>::NodePool()
+{
+    m_freeHead = nullptr;
+    m_used = 0;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+NodePool<T>::~NodePool()
+{
+    Release();
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+T * NodePool<T>::Allocate()
+{
+    m_used++;
+    if (m_freeHead != nullptr)
+    {
+        T * item = m_freeHead;
+        m_freeHead = *reinterpret_cast<T **>(item);
+        return item;
+    }
+
+    if (m_slabs.GetSize() == 0)
+    {
+        AddSlab(POOL_FIRST_SLAB);
+    }
+    else
+    {
+        Slab<T> & last = m_slabs[m_slabs.GetSize() - 1];
+        if (last.used == last.capacity)
+        {
+            AddSlab(last.capacity < POOL_MAX_SLAB ? last.capacity * 2 : POOL_MAX_SLAB);
+        }
+    }
+
+    Slab<T> & current = m_slabs[m_slabs.GetSize() - 1];
+    return current.items + current.used++;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+T * NodePool<T>::AllocateBlock(int n)
+{
+    if (n <= 0)
+    {
+        return nullptr;
+    }
+
+    Reserve(n);
+    Slab<T> & current = m_slabs[m_slabs.GetSize() - 1];
+    T * block = current.items + current.used;
+    current.used += n;
+    m_used += n;
+    return block;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+void NodePool<T>::Free(T * item)
+{
+    ::new (static_cast<void *>(item)) T *(m_freeHead);
+    m_freeHead = item;
+    m_used--;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+void NodePool<T>::Reserve(int n)
+{
+    if (m_slabs.GetSize() > 0)
+    {
+        const Slab<T> & last = m_slabs[m_slabs.GetSize() - 1];
+        if (last.capacity - last.used >= n)
+        {
+            return;
+        }
+    }
+    AddSlab(n > POOL_FIRST_SLAB ? n : POOL_FIRST_SLAB);
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+void NodePool<T>::Release()
+{
+    for (int i = 0; i < m_slabs.GetSize(); i++)
+    {
+        ::operator delete(m_slabs[i].items);
+    }
+    m_slabs.Clear();
+    m_freeHead = nullptr;
+    m_used = 0;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+bool NodePool<T>::IsContiguous() const
+{
+    return m_slabs.GetSize() == 1 && m_freeHead == nullptr;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+T * NodePool<T>::GetFirstSlot() const
+{
+    return (m_slabs.GetSize() > 0) ? m_slabs[0].items : nullptr;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+int NodePool<T>::GetUsed() const
+{
+    return m_used;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+void NodePool<T>::AddSlab(int capacity)
+{
+    Slab<T> slab;
+    slab.items = static_cast<T *>(::operator new(sizeof(T) * static_cast<std::size_t>(capacity)));
+    slab.capacity = capacity;
+    slab.used = 0;
+    m_slabs.PushBack(slab);
+}
+
+//---------------------------------------------------------------------------------------
+
+#endif // NODEPOOL_H
@@ -0,0 +1,197 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+//---------------------------------------------------------------------------------------
+
+#include <thread>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <system_error>
+
+//---------------------------------------------------------------------------------------
+
+    /**
+    * @brief Returns the number of worker threads to use for a batch of tasks.
+    *
+    * Uses the number of hardware threads reported by the system, but never more workers than
+    * there are tasks, and never fewer than one.
+    *
+    * @param taskCount - The number of independent tasks to be run.
+    * @return The number of workers, between 1 and taskCount (or 1 if taskCount < 1).
+    * @pre None.
+    * @post None.
+    */
+inline int GetWorkerCount(int taskCount)
+{
+    int workers = static_cast<int>(std::thread::hardware_concurrency());
+    if (workers < 1)
+    {
+        workers = 1;
+    }
+    if (workers > taskCount)
+    {
+        workers = taskCount;
+    }
+    return (workers < 1) ? 1 : workers;
+}
+
+//---------------------------------------------------------------------------------------
+
+    /**
+    * @class WorkerThreads
+    * @brief Owns the threads started by one ParallelFor call and joins them when it goes out of scope.
+    *
+    * Joining in the destructor means that a std::thread left joinable by an exception never reaches its own
+    * destructor, which would call std::terminate.
+    */
+
+class WorkerThreads {
+public:
+    /**
+    * @brief Construct a WorkerThreads object with room for capacity threads, none of them started.
+    *
+    * @param capacity - the largest number of threads that will be started.
+    * @pre capacity >= 0.
+    * @post GetCount() returns 0.
+    */
+    explicit WorkerThreads(int capacity) : m_threads(new std::thread[capacity]), m_count(0) {}
+
+    /**
+    * @brief Destructor for the WorkerThreads object. Waits for every started thread to finish.
+    *
+    * @pre the object is initialized.
+    * @post every started thread has been joined and the storage released.
+    */
+    ~WorkerThreads()
+    {
+        JoinAll();
+        delete[] m_threads;
+    }
+
+    /**
+    * @brief Starts one more thread running body.
+    *
+    * @tparam F - A callable type taking no arguments.
+    * @param body - The callable the thread runs.
+    * @return void
+    * @pre GetCount() is less than the capacity.
+    * @post If no exception was thrown, GetCount() has grown by one.
+    */
+    template <class F>
+    void Start(F & body)
+    {
+        m_threads[m_count] = std::thread(body);
+        m_count++;
+    }
+
+    /**
+    * @brief Waits for every started thread to finish.
+    *
+    * @return void
+    * @pre None.
+    * @post No thread is joinable.
+    */
+    void JoinAll()
+    {
+        for (int i = 0; i < m_count; i++)
+        {
+            if (m_threads[i].joinable())
+            {
+                m_threads[i].join();
+            }
+        }
+    }
+
+private:
+    std::thread * m_threads; /// Storage for the threads, started or not
+    int m_count; /// Number of threads started
+
+    WorkerThreads(const WorkerThreads & other); /// Not copyable
+    WorkerThreads & operator=(const WorkerThreads & other); /// Not copyable
+};
+
+//---------------------------------------------------------------------------------------
+
+    /**
+    * @brief Runs task(0) to task(taskCount - 1) on worker threads started for this call.
+    *
+    * Starts up to GetWorkerCount(taskCount) - 1 new threads, and the calling thread works alongside them. Each
+    * worker repeatedly claims the next unclaimed index from a shared atomic counter until all indices are taken,
+    * so uneven tasks are balanced across workers. The threads are joined before the function returns, so every
+    * call pays for starting them; give each call enough work to cover that. If a thread cannot be started, the
+    * workers already running finish the tasks. Tasks must not depend on the order in which indices are run;
+    * anything order-sensitive should be written to a per-index slot and combined by the caller afterwards.
+    *
+    * If a task throws, no further indices are claimed, the workers are joined, and the first exception is
+    * rethrown on the calling thread.
+    *
+    * @tparam F - A callable type accepting a single int index.
+    * @param taskCount - The number of tasks to run.
+    * @param task - The callable run once for every index.
+    * @return void
+    * @pre Tasks with different indices may safely run at the same time.
+    * @post task has been called exactly once for every index in [0, taskCount), unless a task threw.
+    */
+template <class F>
+void ParallelFor(int taskCount, F task)
+{
+    int workers = GetWorkerCount(taskCount);
+    if (workers <= 1)
+    {
+        for (int i = 0; i < taskCount; i++)
+        {
+            task(i);
+        }
+        return;
+    }
+
+    std::atomic<int> next(0);
+    std::exception_ptr failure;
+    std::mutex failureMutex;
+    auto worker = [&]()
+    {
+        try
+        {
+            for (int i = next++; i < taskCount; i = next++)
+            {
+                task(i);
+            }
+        }
+        catch (...)
+        {
+            // Keep the first exception and stop the other workers from claiming more indices
+            std::lock_guard<std::mutex> lock(failureMutex);
+            if (!failure)
+            {
+                failure = std::current_exception();
+            }
+            next = taskCount;
+        }
+    };
+
+    {
+        WorkerThreads threads(workers - 1);
+        for (int i = 0; i < workers - 1; i++)
+        {
+            try
+            {
+                threads.Start(worker);
+            }
+            catch (const std::system_error &)
+            {
+                break; // out of threads, so the ones already running share the remaining tasks
+            }
+        }
+        worker();
+    }
+
+    if (failure)
+    {
+        std::rethrow_exception(failure);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+
+#endif // PARALLEL_H
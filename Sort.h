@@ -4,6 +4,9 @@
 //---------------------------------------------------------------------------------------
 
 #include "Vector.h"
+#include "Parallel.h"
+#include <cstdint>
+#include <utility>
 
 //---------------------------------------------------------------------------------------
 
@@ -28,20 +31,36 @@ void Swap(T & a, T & b)
     b = temp;
 }
 
+//----------------------------------------------------------------------------------
+
+/// Ranges of at most this many elements are sorted by insertion sort instead of being split further.
+const int MERGE_SORT_CUTOFF = 24;
+
+/// ParallelMergeSort gives each worker at least this many elements, and sorts smaller ranges on one thread.
+const int PARALLEL_SORT_GRAIN = 8192;
+
+/// RadixSortByTimestamp sorts this many bits of the key per pass.
+const int RADIX_BITS = 11;
+
+/// The number of buckets in each RadixSortByTimestamp pass.
+const int RADIX_BUCKETS = 1 << RADIX_BITS;
+
 //----------------------------------------------------------------------------------
 
     /**
     * @brief Sorts a vector using the Merge Sort algorithm.
     *
-    * This recursive function implements the Merge Sort algorithm to sort
-    * elements in a vector between the given start and end indices.
+    * This function sorts the elements of a vector between the given start and end indices. It allocates a
+    * single scratch buffer of half the range for the whole sort, sorts ranges of up to MERGE_SORT_CUTOFF
+    * elements by insertion sort, and skips the merge of two halves that are already in order, so input that
+    * is already sorted takes O(n) comparisons. The sort is stable: equal elements keep their relative order.
     *
     * @tparam T The type of elements in the vector.
     * @param data The vector to be sorted.
     * @param start The starting index of the segment to sort.
     * @param end The ending index of the segment to sort.
     * @return void
-    * @pre data must be a valid Vector<T> with elements at indices from start to end.
+    * @pre data must be a valid Vector<T> with elements at indices from start to end. T supports operator<.
     * @post The segment data[start...end] is sorted in ascending order.
     */
 template <class T>
@@ -52,21 +71,84 @@ void MergeSort(Vector<T> & data, int start, int end)
         return;
     }
 
-    if (end - start == 1)
+    T * scratch = new T[(end - start) / 2 + 1];
+    MergeSortRange(data, start, end, scratch);
+    delete[] scratch;
+}
+
+//----------------------------------------------------------------------------------
+
+    /**
+    * @brief Recursive helper for MergeSort that reuses a caller-supplied scratch buffer.
+    *
+    * @tparam T The type of elements in the vector.
+    * @param data The vector to be sorted.
+    * @param start The starting index of the segment to sort.
+    * @param end The ending index of the segment to sort.
+    * @param scratch A buffer of at least (end - start) / 2 + 1 elements.
+    * @return void
+    * @pre data must be a valid Vector<T> with elements at indices from start to end.
+    * @post The segment data[start...end] is sorted in ascending order. The contents of scratch are unspecified.
+    */
+template <class T>
+void MergeSortRange(Vector<T> & data, int start, int end, T * scratch)
+{
+    if (end - start < MERGE_SORT_CUTOFF)
     {
-        if (data[start] > data[end])
-        {
-            Swap(data[start], data[end]);
-        }
+        InsertionSort(data, start, end);
         return;
     }
 
     int mid = (start + end) / 2;
 
-    MergeSort(data, start, mid);
-    MergeSort(data, mid + 1, end);
+    MergeSortRange(data, start, mid, scratch);
+    MergeSortRange(data, mid + 1, end, scratch);
 
-    Merge(data, start, mid, end);
+    // The halves are already in order, as happens throughout time-ordered input
+    if (!(data[mid + 1] < data[mid]))
+    {
+        return;
+    }
+
+    MergeWithBuffer(data, start, mid, end, scratch);
+}
+
+//----------------------------------------------------------------------------------
+
+    /**
+    * @brief Sorts a short segment of a vector using the Insertion Sort algorithm.
+    *
+    * Insertion sort is faster than merge sort on a few elements, and takes linear time on a segment that is
+    * already sorted. The sort is stable.
+    *
+    * @tparam T The type of elements in the vector.
+    * @param data The vector to be sorted.
+    * @param start The starting index of the segment to sort.
+    * @param end The ending index of the segment to sort.
+    * @return void
+    * @pre data must be a valid Vector<T> with elements at indices from start to end.
+    * @post The segment data[start...end] is sorted in ascending order.
+    */
+template <class T>
+void InsertionSort(Vector<T> & data, int start, int end)
+{
+    for (int i = start + 1; i <= end; i++)
+    {
+        if (!(data[i] < data[i - 1]))
+        {
+            continue;
+        }
+
+        T value = std::move(data[i]);
+        int j = i;
+        do
+        {
+            data[j] = std::move(data[j - 1]);
+            j--;
+        }
+        while (j > start && value < data[j - 1]);
+        data[j] = std::move(value);
+    }
 }
 
 //----------------------------------------------------------------------------------
@@ -75,7 +157,7 @@ void MergeSort(Vector<T> & data, int start, int end)
     * @brief Merges two sorted halves of a vector into a single sorted segment.
     *
     * This function merges two sorted sub-vectors (from start to mid and mid+1 to end)
-    * into a single sorted segment in the original vector.
+    * into a single sorted segment in the original vector, using a temporary buffer for the first half.
     *
     * @tparam T The type of elements in the vector.
     * @param data The original vector containing the segments to merge.
@@ -89,89 +171,338 @@ void MergeSort(Vector<T> & data, int start, int end)
 template <class T>
 void Merge(Vector<T> & data, int start, int mid, int end)
 {
-    int leftSize = mid - start + 1;
-    int rightSize = end - mid;
+    T * scratch = new T[mid - start + 1];
+    MergeWithBuffer(data, start, mid, end, scratch);
+    delete[] scratch;
+}
 
-    Vector<T> leftVec(leftSize);
-    Vector<T> rightVec(rightSize);
+//----------------------------------------------------------------------------------
 
+    /**
+    * @brief Merges two sorted halves of a vector, moving the first half through a scratch buffer.
+    *
+    * Only the first half is moved out; the merged output is written from start, which can never overtake
+    * the unread part of the second half. When elements compare equal, the one from the first half is taken
+    * first, so the merge is stable.
+    *
+    * @tparam T The type of elements in the vector.
+    * @param data The original vector containing the segments to merge.
+    * @param start The starting index of the first sorted sub-vector.
+    * @param mid The ending index of the first sorted sub-vector (mid + 1 is the start of the second).
+    * @param end The ending index of the second sorted sub-vector.
+    * @param scratch A buffer of at least mid - start + 1 elements.
+    * @return void
+    * @pre data[start...mid] and data[mid+1...end] must be individually sorted.
+    * @post data[start...end] is fully sorted and duplicates are retained.
+    */
+template <class T>
+void MergeWithBuffer(Vector<T> & data, int start, int mid, int end, T * scratch)
+{
+    int leftSize = mid - start + 1;
     for (int i = 0; i < leftSize; i++)
     {
-        leftVec.PushBack(data[start + i]);
+        scratch[i] = std::move(data[start + i]);
     }
-    for (int i = 0; i < rightSize; i++)
+
+    int i = 0;
+    int j = mid + 1;
+    int k = start;
+
+    while (i < leftSize && j <= end)
+    {
+        if (data[j] < scratch[i])
+        {
+            data[k++] = std::move(data[j++]);
+        }
+        else
+        {
+            data[k++] = std::move(scratch[i++]);
+        }
+    }
+
+    // Whatever is left of the second half is already in place
+    while (i < leftSize)
     {
-        rightVec.PushBack(data[mid + 1 + i]);
+        data[k++] = std::move(scratch[i++]);
     }
+}
 
-    int i = 0, j = 0;
-    int k = start;
+//---------------------------------------------------------------------------------------
+
+    /**
+    * @brief Sorts a vector using a merge sort spread across worker threads.
+    *
+    * The range is cut into a power-of-two number of blocks, at least one per worker, and the blocks are
+    * sorted at the same time by MergeSort. Neighbouring runs are then merged level by level between the
+    * vector and one buffer of the same size. Each merge is itself cut into independent parts by
+    * CoRankSplit(), so the final levels, which have fewer merges than workers, still keep every worker
+    * busy. Falls back to MergeSort when the range is too short to split across more than one worker.
+    * The result is identical to MergeSort, including the order of equal elements.
+    *
+    * @tparam T The type of elements in the vector.
+    * @param data The vector to be sorted.
+    * @param start The starting index of the segment to sort.
+    * @param end The ending index of the segment to sort.
+    * @return void
+    * @pre data must be a valid Vector<T> with elements at indices from start to end. T supports operator<,
+    * and elements at different indices may be compared and moved from different threads at the same time.
+    * @post The segment data[start...end] is sorted in ascending order.
+    */
+template <class T>
+void ParallelMergeSort(Vector<T> & data, int start, int end)
+{
+    int count = end - start + 1;
+    int workers = GetWorkerCount(count / PARALLEL_SORT_GRAIN);
+    if (workers <= 1)
+    {
+        MergeSort(data, start, end);
+        return;
+    }
 
-    T datum1 = leftVec[i];
-    T datum2 = rightVec[j];
+    int blocks = 1;
+    while (blocks < workers)
+    {
+        blocks *= 2;
+    }
 
-    while (i < leftVec.GetSize() && j < rightVec.GetSize())
+    T * base = &data[start];
+    ParallelFor(blocks, [&](int b)
     {
-        if (datum1 < datum2)
+        int first = static_cast<int>(static_cast<long long>(count) * b / blocks);
+        int last = static_cast<int>(static_cast<long long>(count) * (b + 1) / blocks) - 1;
+        if (first < last)
         {
-            data[k] = datum1;
-            k++;
-            i++;
-            if (i < leftVec.GetSize())
-            {
-                datum1 = leftVec[i];
-            }
+            T * scratch = new T[(last - first) / 2 + 1];
+            MergeSortRange(data, start + first, start + last, scratch);
+            delete[] scratch;
         }
-        else if (datum2 < datum1)
+    });
+
+    // Each level merges pairs of runs from src into dst, then the two swap roles
+    T * buffer = new T[count];
+    T * src = base;
+    T * dst = buffer;
+    for (int runs = blocks; runs > 1; runs /= 2)
+    {
+        int pairs = runs / 2;
+        int parts = (workers + pairs - 1) / pairs;
+
+        ParallelFor(pairs * parts, [&](int task)
         {
-            data[k] = datum2;
-            k++;
-            j++;
-            if (j < rightVec.GetSize())
+            int pair = task / parts;
+            int part = task % parts;
+            int first = static_cast<int>(static_cast<long long>(count) * (2 * pair) / runs);
+            int mid = static_cast<int>(static_cast<long long>(count) * (2 * pair + 1) / runs);
+            int last = static_cast<int>(static_cast<long long>(count) * (2 * pair + 2) / runs);
+
+            int leftSize = mid - first;
+            int rightSize = last - mid;
+            int outBegin = static_cast<int>(static_cast<long long>(leftSize + rightSize) * part / parts);
+            int outEnd = static_cast<int>(static_cast<long long>(leftSize + rightSize) * (part + 1) / parts);
+
+            int leftBegin = CoRankSplit(src + first, leftSize, src + mid, rightSize, outBegin);
+            int leftEnd = CoRankSplit(src + first, leftSize, src + mid, rightSize, outEnd);
+
+            MergeInto(src + first + leftBegin, src + first + leftEnd,
+                      src + mid + (outBegin - leftBegin), src + mid + (outEnd - leftEnd),
+                      dst + first + outBegin);
+        });
+
+        T * merged = dst;
+        dst = src;
+        src = merged;
+    }
+
+    // An odd number of levels leaves the sorted run in the buffer
+    if (src == buffer)
+    {
+        int chunks = GetWorkerCount(blocks);
+        ParallelFor(chunks, [&](int c)
+        {
+            int first = static_cast<int>(static_cast<long long>(count) * c / chunks);
+            int last = static_cast<int>(static_cast<long long>(count) * (c + 1) / chunks);
+            for (int i = first; i < last; i++)
             {
-                datum2 = rightVec[j];
+                base[i] = std::move(buffer[i]);
             }
+        });
+    }
+    delete[] buffer;
+}
+
+//---------------------------------------------------------------------------------------
+
+    /**
+    * @brief Finds how many of the first k elements of a stable merge come from the left run.
+    *
+    * Binary searches for the split, so a merge can be cut into parts that are merged independently.
+    * Equal elements are taken from the left run first, matching MergeWithBuffer().
+    *
+    * @tparam T The type of elements in the runs.
+    * @param left The first element of the left run.
+    * @param leftSize The number of elements in the left run.
+    * @param right The first element of the right run.
+    * @param rightSize The number of elements in the right run.
+    * @param k The number of merged elements, between 0 and leftSize + rightSize.
+    * @return The number i of left elements among the first k merged elements; the other k - i come from the right.
+    * @pre Both runs are sorted.
+    * @post The runs are unchanged.
+    */
+template <class T>
+int CoRankSplit(const T * left, int leftSize, const T * right, int rightSize, int k)
+{
+    int lo = (k > rightSize) ? k - rightSize : 0;
+    int hi = (k < leftSize) ? k : leftSize;
+
+    // The smallest i for which left[i] is not among the first k, i.e. right[k - i - 1] < left[i]
+    while (lo < hi)
+    {
+        int i = lo + (hi - lo) / 2;
+        if (right[k - i - 1] < left[i])
+        {
+            hi = i;
         }
         else
         {
-            data[k] = datum1;
-            k++;
-            data[k] = datum2;
-            k++;
-            i++;
-            j++;
-            if (i < leftVec.GetSize())
-            {
-                datum1 = leftVec[i];
-            }
-            if (j < rightVec.GetSize())
-            {
-                datum2 = rightVec[j];
-            }
+            lo = i + 1;
         }
     }
+    return lo;
+}
 
-    while (i < leftVec.GetSize())
+//---------------------------------------------------------------------------------------
+
+    /**
+    * @brief Moves the stable merge of two sorted runs into an output range.
+    *
+    * @tparam T The type of elements in the runs.
+    * @param left The first element of the left run.
+    * @param leftEnd One past the last element of the left run.
+    * @param right The first element of the right run.
+    * @param rightEnd One past the last element of the right run.
+    * @param out The first element of the output, with room for both runs.
+    * @return void
+    * @pre Both runs are sorted, and the output does not overlap either run.
+    * @post out holds the elements of both runs in order, equal elements from the left run first.
+    * The elements of the runs have been moved from.
+    */
+template <class T>
+void MergeInto(T * left, T * leftEnd, T * right, T * rightEnd, T * out)
+{
+    while (left < leftEnd && right < rightEnd)
     {
-        data[k] = datum1;
-        k++;
-        i++;
-        if (i < leftVec.GetSize())
+        if (*right < *left)
         {
-            datum1 = leftVec[i];
+            *out++ = std::move(*right++);
         }
+        else
+        {
+            *out++ = std::move(*left++);
+        }
+    }
+    while (left < leftEnd)
+    {
+        *out++ = std::move(*left++);
+    }
+    while (right < rightEnd)
+    {
+        *out++ = std::move(*right++);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+
+    /**
+    * @brief Sorts a vector by its packed timestamp using a least-significant-digit radix sort.
+    *
+    * Elements are distributed by RADIX_BITS bits of their timestamp at a time, starting from the lowest,
+    * between the vector and one buffer of the same size. The keys are taken relative to the smallest
+    * timestamp, so only as many passes run as the span of the data needs (two for a year of minutes, three
+    * for a decade), and a pass in which every key has the same digit is skipped. Each pass is stable, so
+    * elements with the same timestamp keep their original order. Unlike MergeSort, elements with the same
+    * timestamp are not ordered by their other fields.
+    *
+    * @tparam T The type of elements in the vector, which has a std::uint32_t timestamp member.
+    * @param data The vector to be sorted.
+    * @param start The starting index of the segment to sort.
+    * @param end The ending index of the segment to sort.
+    * @return void
+    * @pre data must be a valid Vector<T> with elements at indices from start to end.
+    * @post The segment data[start...end] is sorted by ascending timestamp, ties in their original order.
+    */
+template <class T>
+void RadixSortByTimestamp(Vector<T> & data, int start, int end)
+{
+    int count = end - start + 1;
+    if (count < 2)
+    {
+        return;
+    }
+
+    T * base = &data[start];
+    std::uint32_t lowest = base[0].timestamp;
+    std::uint32_t highest = base[0].timestamp;
+    for (int i = 1; i < count; i++)
+    {
+        if (base[i].timestamp < lowest)
+        {
+            lowest = base[i].timestamp;
+        }
+        if (base[i].timestamp > highest)
+        {
+            highest = base[i].timestamp;
+        }
+    }
+    std::uint32_t span = highest - lowest;
+
+    T * buffer = new T[count];
+    T * src = base;
+    T * dst = buffer;
+    int * offsets = new int[RADIX_BUCKETS];
+    for (int shift = 0; shift < 32 && (span >> shift) != 0; shift += RADIX_BITS)
+    {
+        for (int b = 0; b < RADIX_BUCKETS; b++)
+        {
+            offsets[b] = 0;
+        }
+        for (int i = 0; i < count; i++)
+        {
+            offsets[((src[i].timestamp - lowest) >> shift) & (RADIX_BUCKETS - 1)]++;
+        }
+
+        // Every key has the same digit, so this pass would not move anything
+        if (offsets[((src[0].timestamp - lowest) >> shift) & (RADIX_BUCKETS - 1)] == count)
+        {
+            continue;
+        }
+
+        int total = 0;
+        for (int b = 0; b < RADIX_BUCKETS; b++)
+        {
+            int size = offsets[b];
+            offsets[b] = total;
+            total += size;
+        }
+        for (int i = 0; i < count; i++)
+        {
+            dst[offsets[((src[i].timestamp - lowest) >> shift) & (RADIX_BUCKETS - 1)]++] = std::move(src[i]);
+        }
+
+        T * sorted = dst;
+        dst = src;
+        src = sorted;
     }
+    delete[] offsets;
 
-    while (j < rightVec.GetSize())
+    // An odd number of passes leaves the sorted elements in the buffer
+    if (src == buffer)
     {
-        data[k] = datum2;
-        k++;
-        j++;
-        if (j < rightVec.GetSize())
+        for (int i = 0; i < count; i++)
         {
-            datum2 = rightVec[j];
+            base[i] = std::move(buffer[i]);
         }
     }
+    delete[] buffer;
 }
 
 //---------------------------------------------------------------------------------------
@@ -0,0 +1,511 @@
+#include "../Sort.h"
+#include "../Vector.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+//---------------------------------------------------------------------------------------
+
+/// An element ordered by its key alone, which remembers where it started so the order of ties can be checked.
+typedef struct {
+    std::uint32_t timestamp; /// The sort key, named as in AtmosRecType so the radix sort can use it.
+    int order; /// The index of the element before sorting.
+} SortItemType;
+
+bool operator <(const SortItemType & lhs, const SortItemType & rhs);
+
+void TestOne();
+
+void TestTwo();
+
+void TestThree();
+
+void TestFour();
+
+void TestFive();
+
+void TestSix();
+
+void TestSeven();
+
+void TestEight();
+
+void TestNine();
+
+void BuildItems(Vector<SortItemType> & items, int size, std::uint32_t keys, unsigned int seed);
+
+void BuildSequence(Vector<SortItemType> & items, int size, int step);
+
+void BuildSpread(Vector<SortItemType> & items, int size, int distinct, std::uint32_t span, std::uint32_t lowest,
+                 unsigned int seed);
+
+bool MatchesReference(const Vector<SortItemType> & input, const Vector<SortItemType> & sorted);
+
+bool CheckMergeSort(const Vector<SortItemType> & input);
+
+bool CheckParallelMergeSort(const Vector<SortItemType> & input);
+
+bool CheckSplitMerge(const Vector<SortItemType> & input, int leftSize, int parts);
+
+bool CheckRadixSort(const Vector<SortItemType> & input);
+
+//---------------------------------------------------------------------------------------
+
+int main()
+{
+    std::cout << "Sort Test\n";
+
+    std::cout << "Test One\n";
+    TestOne(); // MergeSort on empty and single-element ranges.
+    std::cout << std::endl;
+
+    std::cout << "Test Two\n";
+    TestTwo(); // MergeSort around MERGE_SORT_CUTOFF, where insertion sort hands over to merging.
+    std::cout << std::endl;
+
+    std::cout << "Test Three\n";
+    TestThree(); // MergeSort on already-sorted, reversed and all-equal input.
+    std::cout << std::endl;
+
+    std::cout << "Test Four\n";
+    TestFour(); // MergeSort of a sub-range, and Merge of two halves that share keys.
+    std::cout << std::endl;
+
+    std::cout << "Test Five\n";
+    TestFive(); // ParallelMergeSort around 2 * PARALLEL_SORT_GRAIN, with few distinct keys.
+    std::cout << std::endl;
+
+    std::cout << "Test Six\n";
+    TestSix(); // A merge cut into parts by CoRankSplit and merged part by part with MergeInto.
+    std::cout << std::endl;
+
+    std::cout << "Test Seven\n";
+    TestSeven(); // RadixSortByTimestamp keeps ties in order over spans needing one, two and three passes.
+    std::cout << std::endl;
+
+    std::cout << "Test Eight\n";
+    TestEight(); // RadixSortByTimestamp on short ranges, a sub-range, and keys whose low digit is constant.
+    std::cout << std::endl;
+
+    std::cout << "Test Nine\n";
+    TestNine(); // ParallelFor runs every index once, and hands an exception thrown by a task back to the caller.
+    std::cout << std::endl;
+
+    return 0;
+}
+
+//---------------------------------------------------------------------------------------
+
+bool operator <(const SortItemType & lhs, const SortItemType & rhs)
+{
+    return lhs.timestamp < rhs.timestamp;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestOne()
+{
+    Vector<SortItemType> empty;
+    MergeSort(empty, 0, empty.GetSize() - 1);
+    std::cout << "Empty vector still empty: " << (empty.GetSize() == 0 ? "yes" : "no") << std::endl;
+
+    Vector<SortItemType> single;
+    BuildItems(single, 1, 10, 1u);
+    std::cout << "Single element unchanged: " << (CheckMergeSort(single) ? "yes" : "no") << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestTwo()
+{
+    // Few distinct keys, so most elements have ties on both sides of every merge
+    bool stable = true;
+    for (int size = MERGE_SORT_CUTOFF - 1; size <= MERGE_SORT_CUTOFF + 1; size++)
+    {
+        Vector<SortItemType> items;
+        BuildItems(items, size, 5, 7u + size);
+        bool matches = CheckMergeSort(items);
+        std::cout << "Size " << size << " sorted stably: " << (matches ? "yes" : "no") << std::endl;
+        stable = stable && matches;
+    }
+
+    // Twice and four times the cutoff, where one and two levels of merges run
+    for (int size = 2 * MERGE_SORT_CUTOFF; size <= 4 * MERGE_SORT_CUTOFF + 1; size++)
+    {
+        Vector<SortItemType> items;
+        BuildItems(items, size, 7, 3u * size);
+        stable = stable && CheckMergeSort(items);
+    }
+    std::cout << "Every size up to four times the cutoff sorted stably: " << (stable ? "yes" : "no") << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestThree()
+{
+    Vector<SortItemType> ascending;
+    BuildSequence(ascending, 1000, 1);
+    std::cout << "Already sorted: " << (CheckMergeSort(ascending) ? "yes" : "no") << std::endl;
+
+    Vector<SortItemType> descending;
+    BuildSequence(descending, 1000, -1);
+    std::cout << "Reversed: " << (CheckMergeSort(descending) ? "yes" : "no") << std::endl;
+
+    Vector<SortItemType> equal;
+    BuildSequence(equal, 1000, 0);
+    std::cout << "All equal, original order kept: " << (CheckMergeSort(equal) ? "yes" : "no") << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestFour()
+{
+    Vector<SortItemType> items;
+    BuildItems(items, 300, 20, 99u);
+    Vector<SortItemType> sorted = items;
+    MergeSort(sorted, 50, 249);
+
+    bool outside = true;
+    for (int i = 0; i < items.GetSize(); i++)
+    {
+        if (i < 50 || i > 249)
+        {
+            outside = outside && sorted[i].order == items[i].order;
+        }
+    }
+    std::vector<SortItemType> reference(items.GetData() + 50, items.GetData() + 250);
+    std::stable_sort(reference.begin(), reference.end());
+    bool inside = true;
+    for (int i = 50; i <= 249; i++)
+    {
+        inside = inside && sorted[i].order == reference[i - 50].order;
+    }
+    std::cout << "Sub-range sorted stably: " << (inside ? "yes" : "no") << std::endl;
+    std::cout << "Elements outside the sub-range untouched: " << (outside ? "yes" : "no") << std::endl;
+
+    // Both halves hold keys 0 to 9; each key of the left half must come before the same key of the right
+    Vector<SortItemType> halves;
+    BuildSequence(halves, 20, 0);
+    for (int i = 0; i < 20; i++)
+    {
+        halves[i].timestamp = i % 10;
+    }
+    Merge(halves, 0, 9, 19);
+    bool merged = true;
+    for (int i = 0; i < 20; i++)
+    {
+        merged = merged && halves[i].timestamp == static_cast<std::uint32_t>(i / 2) &&
+                 halves[i].order == (i % 2 == 0 ? i / 2 : 10 + i / 2);
+    }
+    std::cout << "Merge takes ties from the left half first: " << (merged ? "yes" : "no") << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestFive()
+{
+    // The sort only splits from 2 * PARALLEL_SORT_GRAIN elements, and only on a processor with several hardware
+    // threads; with one it must still give the MergeSort result
+    std::cout << "Workers for " << 2 * PARALLEL_SORT_GRAIN << " elements: "
+              << GetWorkerCount(2) << std::endl;
+
+    int sizes[] = {2 * PARALLEL_SORT_GRAIN - 1, 2 * PARALLEL_SORT_GRAIN, 2 * PARALLEL_SORT_GRAIN + 1,
+                   6 * PARALLEL_SORT_GRAIN + 1, 16 * PARALLEL_SORT_GRAIN + 3};
+    for (int s = 0; s < 5; s++)
+    {
+        Vector<SortItemType> items;
+        BuildItems(items, sizes[s], 3, 17u + s);
+        std::cout << "Size " << sizes[s] << " with 3 distinct keys sorted stably: "
+                  << (CheckParallelMergeSort(items) ? "yes" : "no") << std::endl;
+    }
+
+    Vector<SortItemType> spread;
+    BuildItems(spread, 2 * PARALLEL_SORT_GRAIN + 1, 1000, 5u);
+    std::cout << "Size " << spread.GetSize() << " with 1000 distinct keys sorted stably: "
+              << (CheckParallelMergeSort(spread) ? "yes" : "no") << std::endl;
+
+    Vector<SortItemType> equal;
+    BuildSequence(equal, 2 * PARALLEL_SORT_GRAIN, 0);
+    std::cout << "All equal, original order kept: " << (CheckParallelMergeSort(equal) ? "yes" : "no") << std::endl;
+
+    Vector<SortItemType> descending;
+    BuildSequence(descending, 4 * PARALLEL_SORT_GRAIN, -1);
+    std::cout << "Reversed: " << (CheckParallelMergeSort(descending) ? "yes" : "no") << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestSix()
+{
+    // Independent of the number of hardware threads: every cut of every merge is checked directly
+    bool stable = true;
+    int sizes[] = {0, 1, 2, 7, 100, 1001};
+    for (int s = 0; s < 6; s++)
+    {
+        Vector<SortItemType> items;
+        BuildItems(items, sizes[s], 4, 23u + s);
+        for (int leftSize = 0; leftSize <= sizes[s]; leftSize += (sizes[s] < 10 ? 1 : 97))
+        {
+            for (int parts = 1; parts <= 9; parts++)
+            {
+                stable = stable && CheckSplitMerge(items, leftSize, parts);
+            }
+        }
+    }
+    std::cout << "Parts merged independently match a stable merge: " << (stable ? "yes" : "no") << std::endl;
+
+    // Every element of both runs is equal, so the split must take the whole left run first
+    SortItemType left[4] = {{5, 0}, {5, 1}, {5, 2}, {5, 3}};
+    SortItemType right[3] = {{5, 4}, {5, 5}, {5, 6}};
+    bool leftFirst = true;
+    for (int k = 0; k <= 7; k++)
+    {
+        leftFirst = leftFirst && CoRankSplit(left, 4, right, 3, k) == (k < 4 ? k : 4);
+    }
+    std::cout << "Ties split from the left run first: " << (leftFirst ? "yes" : "no") << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestSeven()
+{
+    // Spans below 2^11, 2^22 and 2^32 need one, two and three passes; one and three leave the result in the buffer
+    std::uint32_t spans[] = {RADIX_BUCKETS - 1, RADIX_BUCKETS * RADIX_BUCKETS - 1, 4000000000u};
+    const char * const passes[] = {"1 pass", "2 passes", "3 passes"};
+    for (int s = 0; s < 3; s++)
+    {
+        // Few distinct timestamps over many elements, so every timestamp is shared by hundreds of elements
+        Vector<SortItemType> items;
+        BuildSpread(items, 5000, 12, spans[s], 0, 41u + s);
+        std::cout << "Span " << spans[s] << " (" << passes[s] << "), ties kept in order: "
+                  << (CheckRadixSort(items) ? "yes" : "no") << std::endl;
+    }
+
+    // Timestamps of a year of 10-minute readings start far from 0, and only their span sets the passes
+    Vector<SortItemType> offset;
+    BuildSpread(offset, 5000, 300, RADIX_BUCKETS * 100, 400000000u, 8u);
+    std::cout << "Span far from 0, ties kept in order: " << (CheckRadixSort(offset) ? "yes" : "no") << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestEight()
+{
+    Vector<SortItemType> empty;
+    RadixSortByTimestamp(empty, 0, empty.GetSize() - 1);
+    Vector<SortItemType> single;
+    BuildItems(single, 1, 10, 2u);
+    std::cout << "Empty and single-element ranges: "
+              << (empty.GetSize() == 0 && CheckRadixSort(single) ? "yes" : "no") << std::endl;
+
+    Vector<SortItemType> equal;
+    BuildSequence(equal, 1000, 0);
+    std::cout << "All equal, original order kept: " << (CheckRadixSort(equal) ? "yes" : "no") << std::endl;
+
+    // Every timestamp is a multiple of RADIX_BUCKETS, so the first pass is skipped and one pass moves elements
+    Vector<SortItemType> skipped;
+    BuildSpread(skipped, 3000, 50, RADIX_BUCKETS * 49, 0, 13u);
+    std::cout << "Constant low digit, ties kept in order: " << (CheckRadixSort(skipped) ? "yes" : "no") << std::endl;
+
+    Vector<SortItemType> items;
+    BuildSpread(items, 400, 30, RADIX_BUCKETS * RADIX_BUCKETS, 0, 77u);
+    Vector<SortItemType> sorted = items;
+    RadixSortByTimestamp(sorted, 100, 299);
+    Vector<SortItemType> inside;
+    Vector<SortItemType> reference;
+    bool outside = true;
+    for (int i = 0; i < items.GetSize(); i++)
+    {
+        if (i < 100 || i > 299)
+        {
+            outside = outside && sorted[i].order == items[i].order;
+        }
+        else
+        {
+            reference.PushBack(items[i]);
+            inside.PushBack(sorted[i]);
+        }
+    }
+    std::cout << "Sub-range sorted stably: " << (MatchesReference(reference, inside) ? "yes" : "no") << std::endl;
+    std::cout << "Elements outside the sub-range untouched: " << (outside ? "yes" : "no") << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestNine()
+{
+    const int taskCount = 10000;
+    std::vector<std::atomic<int> > runs(taskCount);
+    for (int i = 0; i < taskCount; i++)
+    {
+        runs[i] = 0;
+    }
+    ParallelFor(taskCount, [&](int i) { runs[i]++; });
+    bool once = true;
+    for (int i = 0; i < taskCount; i++)
+    {
+        once = once && runs[i] == 1;
+    }
+    std::cout << "Every index run exactly once: " << (once ? "yes" : "no") << std::endl;
+
+    // Every task after the first few throws, so each worker that claims one stops early
+    std::atomic<int> started(0);
+    bool caught = false;
+    try
+    {
+        ParallelFor(taskCount, [&](int i)
+        {
+            started++;
+            if (i >= 3)
+            {
+                throw std::runtime_error("task failed");
+            }
+        });
+    }
+    catch (const std::runtime_error & e)
+    {
+        caught = std::string(e.what()) == "task failed";
+    }
+    std::cout << "Exception from a task reaches the caller: " << (caught ? "yes" : "no") << std::endl;
+    std::cout << "No further indices claimed after it: " << (started < taskCount ? "yes" : "no") << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void BuildItems(Vector<SortItemType> & items, int size, std::uint32_t keys, unsigned int seed)
+{
+    // Fixed-seed linear congruential generator, so every run sorts the same input
+    for (int i = 0; i < size; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        SortItemType item;
+        item.timestamp = (seed >> 8) % keys;
+        item.order = i;
+        items.PushBack(item);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+
+void BuildSequence(Vector<SortItemType> & items, int size, int step)
+{
+    for (int i = 0; i < size; i++)
+    {
+        SortItemType item;
+        item.timestamp = static_cast<std::uint32_t>(size + step * i);
+        item.order = i;
+        items.PushBack(item);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+
+void BuildSpread(Vector<SortItemType> & items, int size, int distinct, std::uint32_t span, std::uint32_t lowest,
+                 unsigned int seed)
+{
+    // The distinct timestamps are evenly spaced from lowest to lowest + span, and always include both ends
+    for (int i = 0; i < size; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        int step = (i < 2) ? i * (distinct - 1) : static_cast<int>((seed >> 8) % distinct);
+        SortItemType item;
+        item.timestamp = lowest + static_cast<std::uint32_t>(static_cast<std::uint64_t>(span) * step / (distinct - 1));
+        item.order = i;
+        items.PushBack(item);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+
+bool MatchesReference(const Vector<SortItemType> & input, const Vector<SortItemType> & sorted)
+{
+    if (input.GetSize() != sorted.GetSize())
+    {
+        return false;
+    }
+
+    std::vector<SortItemType> reference;
+    for (int i = 0; i < input.GetSize(); i++)
+    {
+        reference.push_back(input[i]);
+    }
+    std::stable_sort(reference.begin(), reference.end());
+
+    // The order field tells equal keys apart, so this also checks that ties kept their original order
+    for (int i = 0; i < sorted.GetSize(); i++)
+    {
+        if (sorted[i].timestamp != reference[i].timestamp || sorted[i].order != reference[i].order)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------------------
+
+bool CheckMergeSort(const Vector<SortItemType> & input)
+{
+    Vector<SortItemType> sorted = input;
+    MergeSort(sorted, 0, sorted.GetSize() - 1);
+    return MatchesReference(input, sorted);
+}
+
+//---------------------------------------------------------------------------------------
+
+bool CheckParallelMergeSort(const Vector<SortItemType> & input)
+{
+    Vector<SortItemType> sorted = input;
+    ParallelMergeSort(sorted, 0, sorted.GetSize() - 1);
+    return MatchesReference(input, sorted);
+}
+
+//---------------------------------------------------------------------------------------
+
+bool CheckSplitMerge(const Vector<SortItemType> & input, int leftSize, int parts)
+{
+    // Sort the two runs separately, then merge them the way one level of ParallelMergeSort does
+    Vector<SortItemType> runs = input;
+    MergeSort(runs, 0, leftSize - 1);
+    MergeSort(runs, leftSize, runs.GetSize() - 1);
+    Vector<SortItemType> source = runs;
+
+    int total = runs.GetSize();
+    int rightSize = total - leftSize;
+    SortItemType * left = runs.GetData();
+    SortItemType * right = left + leftSize;
+    SortItemType * out = new SortItemType[total + 1];
+    for (int part = 0; part < parts; part++)
+    {
+        int outBegin = total * part / parts;
+        int outEnd = total * (part + 1) / parts;
+        int leftBegin = CoRankSplit(left, leftSize, right, rightSize, outBegin);
+        int leftEnd = CoRankSplit(left, leftSize, right, rightSize, outEnd);
+        MergeInto(left + leftBegin, left + leftEnd, right + (outBegin - leftBegin), right + (outEnd - leftEnd),
+                  out + outBegin);
+    }
+
+    // The runs were stable, so a stable sort of them in order is the stable merge
+    Vector<SortItemType> merged;
+    for (int i = 0; i < total; i++)
+    {
+        merged.PushBack(out[i]);
+    }
+    delete[] out;
+    return MatchesReference(source, merged);
+}
+
+//---------------------------------------------------------------------------------------
+
+bool CheckRadixSort(const Vector<SortItemType> & input)
+{
+    Vector<SortItemType> sorted = input;
+    RadixSortByTimestamp(sorted, 0, sorted.GetSize() - 1);
+    return MatchesReference(input, sorted);
+}
+
+//---------------------------------------------------------------------------------------
@@ -4,6 +4,9 @@
 //---------------------------------------------------------------------------------------
 
 #include <cassert>
+#include <cstddef>
+#include <new>
+#include <utility>
 
 //---------------------------------------------------------------------------------------
 
@@ -12,9 +15,13 @@
     * @brief A simplified dynamic array template class.
     *
     * This class provides a basic implementation of a dynamic array similar to std::vector,
-    * with support for element insertion, access, copying, and dynamic resizing. It manages
-    * its own memory, grows based on size heuristics, and ensures safe access using bounds assertions.
-    * The class supports copy construction, assignment, and const-based indexing.
+    * with support for element insertion, access, copying, moving, and dynamic resizing. It manages
+    * its own memory, and ensures safe access using bounds assertions.
+    * The class supports copy and move construction, assignment, and const-based indexing.
+    *
+    * Storage is allocated raw and elements are constructed in place only when they are inserted, so unused
+    * capacity never holds default-constructed objects. The capacity doubles whenever it runs out, so n insertions
+    * perform O(log n) allocations.
     *
     * @author Nabeel
     * @version 01
@@ -28,6 +35,19 @@
     * @version 03
     * @date 15/06/2025 Nabeel, Overloaded constructor asserts that capacity param >= 0
     *
+    * @author agent
+    * @version 04
+    * @date 17/10/2026 agent, Raw storage with placement construction, geometric growth, Reserve, ShrinkToFit,
+    *       EmplaceBack and move semantics
+    *
+    * @author agent
+    * @version 05
+    * @date 17/10/2026 agent, Added PopBack
+    *
+    * @author agent
+    * @version 06
+    * @date 17/10/2026 agent, Added GetData for kernels that work on the raw array
+    *
     * @todo Nothing
     *
     * @bug No bugs so far
@@ -53,8 +73,8 @@ public:
     * @brief  Construct a Vector object using the passed parameters.
     *
     * This constructor will overload the default constructor, passing value for the capacity. It will then
-    * assign the capacity value and dynamically allocate space on the heap for the internal array using the capacity value.
-    * It also sets the value of size to 0.
+    * assign the capacity value and dynamically allocate uninitialised space on the heap for n elements.
+    * It also sets the value of size to 0; no elements are constructed.
     *
     * @param n - capacity of the array.
     * @pre n is a non-negative integer.
@@ -70,11 +90,22 @@ public:
     *
     * @param other - the Vector object to be copied.
     * @pre other is a valid constructed Vector object.
-    * @post a vector object is created with m_size = other.m_size, m_capacity = other.m_capacity, and m_data array
+    * @post a vector object is created with m_size = other.m_size, m_capacity = other.m_size, and m_data array
     *       being allocated space on the heap and containing copied elements of other's array.
     */
     Vector(const Vector<T>& other);
 
+    /**
+    * @brief  Construct a Vector object by taking over the array of another Vector object.
+    *
+    * No elements are copied or allocated; other is left empty.
+    *
+    * @param other - the Vector object to be moved from.
+    * @pre other is a valid constructed Vector object.
+    * @post this object holds other's former elements, size and capacity. other has size and capacity 0.
+    */
+    Vector(Vector<T>&& other) noexcept;
+
     /**
     * @brief  Destructor for the Vector object.
     *
@@ -93,11 +124,23 @@ public:
     * @param other - the Vector object to be copied.
     * @return a reference to the assigned Vector object.
     * @pre other is a valid constructed Vector object.
-    * @post the assigned vector object's private members are assigned as m_size = other.m_size, m_capacity = other.m_capacity,
+    * @post the assigned vector object's private members are assigned as m_size = other.m_size, m_capacity = other.m_size,
     *       and m_data array being allocated space on the heap and containing copied elements of other's array.
     */
     Vector<T>& operator=(const Vector<T>& other);
 
+    /**
+    * @brief Overloaded assignment operator for taking over the array of another Vector object.
+    *
+    * Frees the elements of the assigned object, then takes over other's array without copying it.
+    *
+    * @param other - the Vector object to be moved from.
+    * @return a reference to the assigned Vector object.
+    * @pre other is a valid constructed Vector object.
+    * @post this object holds other's former elements, size and capacity. other has size and capacity 0.
+    */
+    Vector<T>& operator=(Vector<T>&& other) noexcept;
+
     /**
     * @brief Overloaded subscript operator for accessing and modifying elements.
     *
@@ -127,16 +170,74 @@ public:
     /**
     * @brief Insert an element at the end of the internal array, growing the array if needed.
     *
-    * This function inserts the passed element into the end of the internal array and increases the size by 1.
-    * If size is greater than half the total capacity, the internal array is grown to have at least more than half capacity available.
+    * This function copies the passed element into the end of the internal array and increases the size by 1.
+    * If the array is full, its capacity is doubled first.
     *
     * @param val - a const reference to the element.
-    * @return a const reference to the element at the specified index.
-    * @pre index must be within the bounds of the Vector (0 <= index < m_size).
-    * @post The element at the specified index is accessed, but not modified.
+    * @return void
+    * @pre val may be an element of this Vector.
+    * @post val is the last element, and the size has grown by 1.
     */
     void PushBack(const T& val);
 
+    /**
+    * @brief Move an element to the end of the internal array, growing the array if needed.
+    *
+    * @param val - an rvalue reference to the element, which is moved from.
+    * @return void
+    * @pre None.
+    * @post The former value of val is the last element, and the size has grown by 1.
+    */
+    void PushBack(T&& val);
+
+    /**
+    * @brief Construct an element in place at the end of the internal array, growing the array if needed.
+    *
+    * The element is constructed directly in the array from args, without a temporary.
+    *
+    * @tparam Args - The types of the constructor arguments.
+    * @param args - The arguments passed to T's constructor.
+    * @return void
+    * @pre T has a constructor accepting args. args may refer to elements of this Vector.
+    * @post T(args...) is the last element, and the size has grown by 1.
+    */
+    template <class... Args>
+    void EmplaceBack(Args&&... args);
+
+    /**
+    * @brief Remove the last element of the internal array.
+    *
+    * The element is destroyed and the size shrinks by 1. The capacity is unchanged, so a Vector used as a stack
+    * does not reallocate once it has reached its deepest point.
+    *
+    * @return void
+    * @pre The Vector is not empty.
+    * @post The former last element is destroyed, and the size has shrunk by 1.
+    */
+    void PopBack();
+
+    /**
+    * @brief Ensure the internal array has room for at least n elements.
+    *
+    * Reallocates once if the capacity is smaller than n, so that the next n - size insertions do not reallocate.
+    * Never reduces the capacity.
+    *
+    * @param n - the number of elements to make room for.
+    * @return void
+    * @pre n >= 0.
+    * @post m_capacity >= n. The elements and size are unchanged.
+    */
+    void Reserve(int n);
+
+    /**
+    * @brief Release the unused capacity of the internal array.
+    *
+    * @return void
+    * @pre None.
+    * @post m_capacity == m_size. The elements are unchanged.
+    */
+    void ShrinkToFit();
+
     /**
     * @brief Returns the value of the size variable as an integer.
     *
@@ -159,11 +260,32 @@ public:
     */
     int GetCapacity() const;
 
+    /**
+    * @brief Returns a pointer to the first element of the internal array.
+    *
+    * The elements are contiguous, so the pointer can be passed to code that works on a plain array, such as the
+    * vectorized kernels in FloatKernels.h, without going through the bounds-checked operator[].
+    *
+    * @return A pointer to the first element, or nullptr if no storage has been allocated.
+    * @pre None.
+    * @post The object remains unchanged. The pointer is invalidated by any operation that reallocates the array.
+    */
+    T* GetData();
+
+    /**
+    * @brief Returns a read-only pointer to the first element of the internal array.
+    *
+    * @return A const pointer to the first element, or nullptr if no storage has been allocated.
+    * @pre None.
+    * @post The object remains unchanged. The pointer is invalidated by any operation that reallocates the array.
+    */
+    const T* GetData() const;
+
     /**
     * @brief Deallocate the memory used by the Vector's internal array.
     *
-    * This function releases the memory previously allocated on the heap and sets the internal pointer to nullptr.
-    * It also resets the values of size and capacity.
+    * This function destroys the elements, releases the memory previously allocated on the heap and sets the internal
+    * pointer to nullptr. It also resets the values of size and capacity.
     *
     * @pre m_data points to a dynamically allocated array or is already nullptr.
     * @post m_data is set to nullptr and previously allocated memory is freed.
@@ -178,14 +300,34 @@ private:
     * @brief Copy the contents of another Vector object into the current object.
     *
     * This function copies the private member values and dynamic array of another Vector object into the current object.
-    * It allocates a new array on the heap and copies the data from the passed Vector object.
+    * It allocates a new array on the heap, just large enough for other's elements, and copy-constructs them into it.
     *
     * @param other - the Vector object to be copied.
-    * @pre other is a valid constructed Vector object.
-    * @post m_size and m_capacity are updated to match other, and m_data points to a new array
+    * @pre other is a valid constructed Vector object, and this object holds no array.
+    * @post m_size and m_capacity are equal to other's size, and m_data points to a new array
     *       with the same elements as other.
     */
     void Copy(const Vector<T>& other);
+
+    /**
+    * @brief Move the elements into a new array of the given capacity.
+    *
+    * @param newCapacity - the capacity of the new array.
+    * @return void
+    * @pre newCapacity >= m_size.
+    * @post m_data points to a new array of newCapacity elements holding the same elements, and the old array is freed.
+    */
+    void Reallocate(int newCapacity);
+
+    /**
+    * @brief Allocate uninitialised storage for n elements.
+    *
+    * @param n - the number of elements.
+    * @return a pointer to the storage, or nullptr if n is 0.
+    * @pre n >= 0.
+    * @post No elements are constructed.
+    */
+    static T* Allocate(int n);
 };  // end of class
 
 //---------------------------------------------------------------------------------------
@@ -206,7 +348,7 @@ Vector<T>::Vector(int n)
     assert(n >= 0);
     m_size = 0;
     m_capacity = n;
-    m_data = new T[m_capacity];
+    m_data = Allocate(m_capacity);
 }
 
 //---------------------------------------------------------------------------------------
@@ -219,6 +361,19 @@ Vector<T>::Vector(const Vector<T>& other)
 
 //---------------------------------------------------------------------------------------
 
+template <class T>
+Vector<T>::Vector(Vector<T>&& other) noexcept
+{
+    m_data = other.m_data;
+    m_size = other.m_size;
+    m_capacity = other.m_capacity;
+    other.m_data = nullptr;
+    other.m_size = 0;
+    other.m_capacity = 0;
+}
+
+//---------------------------------------------------------------------------------------
+
 template <class T>
 Vector<T>::~Vector()
 {
@@ -240,6 +395,24 @@ Vector<T>& Vector<T>::operator=(const Vector<T>& other)
 
 //---------------------------------------------------------------------------------------
 
+template <class T>
+Vector<T>& Vector<T>::operator=(Vector<T>&& other) noexcept
+{
+    if (this != &other)
+    {
+        Clear();
+        m_data = other.m_data;
+        m_size = other.m_size;
+        m_capacity = other.m_capacity;
+        other.m_data = nullptr;
+        other.m_size = 0;
+        other.m_capacity = 0;
+    }
+    return *this;
+}
+
+//---------------------------------------------------------------------------------------
+
 template <class T>
 T& Vector<T>::operator[](int index)
 {
@@ -261,26 +434,76 @@ const T& Vector<T>::operator[](int index) const
 template <class T>
 void Vector<T>::PushBack(const T& val)
 {
-    if (m_capacity == 0)
+    EmplaceBack(val);
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+void Vector<T>::PushBack(T&& val)
+{
+    EmplaceBack(std::move(val));
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+template <class... Args>
+void Vector<T>::EmplaceBack(Args&&... args)
+{
+    if (m_size < m_capacity)
     {
-        m_capacity = 1;
-        m_data = new T[m_capacity];
+        new (m_data + m_size) T(std::forward<Args>(args)...);
+        m_size++;
+        return;
     }
 
-    m_data[m_size] = val;
+    // Construct the new element before the old array is released, because args may refer into it
+    int newCapacity = (m_capacity < 4) ? 4 : m_capacity * 2;
+    T* newData = Allocate(newCapacity);
+    new (newData + m_size) T(std::forward<Args>(args)...);
+    for (int i = 0; i < m_size; i++)
+    {
+        new (newData + i) T(std::move(m_data[i]));
+        m_data[i].~T();
+    }
+    ::operator delete(m_data);
+
+    m_data = newData;
+    m_capacity = newCapacity;
     m_size++;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+void Vector<T>::PopBack()
+{
+    assert(m_size > 0);
+    m_size--;
+    m_data[m_size].~T();
+}
+
+//---------------------------------------------------------------------------------------
 
-    if (m_size > (m_capacity / 2))
+template <class T>
+void Vector<T>::Reserve(int n)
+{
+    assert(n >= 0);
+    if (n > m_capacity)
     {
-        int newCapacity = m_capacity + m_size + 1;
-        T* newData = new T[newCapacity];
-        for (int i = 0; i < m_size; i++)
-        {
-            newData[i] = m_data[i];
-        }
-        delete[] m_data;
-        m_data = newData;
-        m_capacity = newCapacity;
+        Reallocate(n);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+void Vector<T>::ShrinkToFit()
+{
+    if (m_capacity > m_size)
+    {
+        Reallocate(m_size);
     }
 }
 
@@ -302,10 +525,30 @@ int Vector<T>::GetCapacity() const
 
 //---------------------------------------------------------------------------------------
 
+template <class T>
+T* Vector<T>::GetData()
+{
+    return m_data;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+const T* Vector<T>::GetData() const
+{
+    return m_data;
+}
+
+//---------------------------------------------------------------------------------------
+
 template <class T>
 void Vector<T>::Clear()
 {
-    delete[] m_data;
+    for (int i = 0; i < m_size; i++)
+    {
+        m_data[i].~T();
+    }
+    ::operator delete(m_data);
     m_data = nullptr;
     m_size = 0;
     m_capacity = 0;
@@ -317,12 +560,41 @@ template <class T>
 void Vector<T>::Copy(const Vector<T>& other)
 {
     m_size = other.GetSize();
-    m_capacity = other.GetCapacity();
-    m_data = new T[m_capacity];
+    m_capacity = m_size;
+    m_data = Allocate(m_capacity);
     for (int i = 0; i < m_size; i++)
     {
-        m_data[i] = other[i];
+        new (m_data + i) T(other[i]);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+void Vector<T>::Reallocate(int newCapacity)
+{
+    T* newData = Allocate(newCapacity);
+    for (int i = 0; i < m_size; i++)
+    {
+        new (newData + i) T(std::move(m_data[i]));
+        m_data[i].~T();
+    }
+    ::operator delete(m_data);
+
+    m_data = newData;
+    m_capacity = newCapacity;
+}
+
+//---------------------------------------------------------------------------------------
+
+template <class T>
+T* Vector<T>::Allocate(int n)
+{
+    if (n == 0)
+    {
+        return nullptr;
     }
+    return static_cast<T*>(::operator new(sizeof(T) * static_cast<std::size_t>(n)));
 }
 
 //---------------------------------------------------------------------------------------
@@ -48,6 +48,36 @@ void TestNineteen();
 
 void TestTwenty();
 
+void TestTwentyOne();
+
+void TestTwentyTwo();
+
+void TestTwentyThree();
+
+void TestTwentyFour();
+
+void TestTwentyFive();
+
+void TestTwentySix();
+
+void TestTwentySeven();
+
+void TestTwentyEight();
+
+/// A type that counts how many of its objects are currently alive.
+struct Counted
+{
+    static int s_alive; /// Number of Counted objects constructed and not yet destroyed.
+    int value; /// The payload.
+
+    Counted() : value(0) { s_alive++; }
+    Counted(int v) : value(v) { s_alive++; }
+    Counted(const Counted & other) : value(other.value) { s_alive++; }
+    ~Counted() { s_alive--; }
+};
+
+int Counted::s_alive = 0;
+
 void PassByValue(Vector<int> vec_copy);
 
 void PassByRef(Vector<int> & vec_ref);
@@ -88,11 +118,11 @@ int main()
     std::cout << std::endl;
 
     std::cout << "Test Five\n";
-    TestFive(); // Copy constructor copies all elements, size, and capacity.
+    TestFive(); // Copy constructor copies all elements and size, with capacity fitted to size.
     std::cout << std::endl;
 
     std::cout << "Test Six\n";
-    TestSix(); // Assignment operator copies all elements, size, and capacity.
+    TestSix(); // Assignment operator copies all elements and size, with capacity fitted to size.
     std::cout << std::endl;
 
     std::cout << "Test Seven\n";
@@ -151,6 +181,38 @@ int main()
     TestTwenty(); // Constructing a vector using capacity < 0 will not work.
     std::cout << std::endl;
 
+    std::cout << "Test Twenty One\n";
+    TestTwentyOne(); // Reserve() sets capacity without changing size, and PushBack() up to it does not reallocate.
+    std::cout << std::endl;
+
+    std::cout << "Test Twenty Two\n";
+    TestTwentyTwo(); // ShrinkToFit() reduces capacity to size and keeps the elements.
+    std::cout << std::endl;
+
+    std::cout << "Test Twenty Three\n";
+    TestTwentyThree(); // EmplaceBack() constructs elements in place from constructor arguments.
+    std::cout << std::endl;
+
+    std::cout << "Test Twenty Four\n";
+    TestTwentyFour(); // Move constructor and move assignment take over the array and leave the source empty.
+    std::cout << std::endl;
+
+    std::cout << "Test Twenty Five\n";
+    TestTwentyFive(); // 500000 PushBack() calls perform a logarithmic number of reallocations.
+    std::cout << std::endl;
+
+    std::cout << "Test Twenty Six\n";
+    TestTwentySix(); // Unused capacity holds no constructed objects, and every element is destroyed.
+    std::cout << std::endl;
+
+    std::cout << "Test Twenty Seven\n";
+    TestTwentySeven(); // PopBack() destroys the last element and keeps the capacity.
+    std::cout << std::endl;
+
+    std::cout << "Test Twenty Eight\n";
+    TestTwentyEight(); // GetData() points at the elements in order, and is null for an empty vector.
+    std::cout << std::endl;
+
     return 0;
 }
 
@@ -386,6 +448,165 @@ void TestTwenty()
 
 //---------------------------------------------------------------------------------------
 
+void TestTwentyOne()
+{
+    Vector<int> v;
+    v.Reserve(100);
+    std::cout << "Size: " << v.GetSize() << std::endl;
+    std::cout << "Capacity: " << v.GetCapacity() << std::endl;
+
+    v.PushBack(1);
+    int * first = &v[0];
+    for (int i = 2; i <= 100; i++)
+    {
+        v.PushBack(i);
+    }
+    std::cout << "Size: " << v.GetSize() << std::endl;
+    std::cout << "Capacity: " << v.GetCapacity() << std::endl;
+    std::cout << "Array moved: " << (first != &v[0] ? "yes" : "no") << std::endl;
+
+    v.Reserve(10);
+    std::cout << "Capacity after smaller Reserve: " << v.GetCapacity() << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestTwentyTwo()
+{
+    Vector<int> v(50);
+    v.PushBack(1);
+    v.PushBack(2);
+    v.PushBack(3);
+    v.ShrinkToFit();
+    std::cout << "v[0], v[1], v[2]: " << v[0] << ", " << v[1] << ", " << v[2] << std::endl;
+    std::cout << "Size: " << v.GetSize() << std::endl;
+    std::cout << "Capacity: " << v.GetCapacity() << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestTwentyThree()
+{
+    Vector<Date> v;
+    v.EmplaceBack(25, 12, 2024);
+    v.EmplaceBack(1, 1, 2025);
+    v.EmplaceBack(v[0]);
+    printVec(v);
+    std::cout << "Size: " << v.GetSize() << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestTwentyFour()
+{
+    Vector<int> v1;
+    v1.PushBack(1);
+    v1.PushBack(2);
+    int * data = &v1[0];
+
+    Vector<int> v2(std::move(v1));
+    std::cout << "v2[0], v2[1]: " << v2[0] << ", " << v2[1] << std::endl;
+    std::cout << "Same array: " << (data == &v2[0] ? "yes" : "no") << std::endl;
+    std::cout << "v1 Size: " << v1.GetSize() << ", Capacity: " << v1.GetCapacity() << std::endl;
+
+    Vector<int> v3;
+    v3.PushBack(7);
+    v3 = std::move(v2);
+    std::cout << "v3[0], v3[1]: " << v3[0] << ", " << v3[1] << std::endl;
+    std::cout << "Same array: " << (data == &v3[0] ? "yes" : "no") << std::endl;
+    std::cout << "v2 Size: " << v2.GetSize() << ", Capacity: " << v2.GetCapacity() << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestTwentyFive()
+{
+    Vector<int> v;
+    int reallocations = 0;
+    int capacity = v.GetCapacity();
+
+    for (int i = 0; i < 500000; i++)
+    {
+        v.PushBack(i);
+        if (v.GetCapacity() != capacity)
+        {
+            capacity = v.GetCapacity();
+            reallocations++;
+        }
+    }
+    std::cout << "Size: " << v.GetSize() << std::endl;
+    std::cout << "Capacity: " << v.GetCapacity() << std::endl;
+    std::cout << "Reallocations: " << reallocations << std::endl;
+    std::cout << "v[499999]: " << v[499999] << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestTwentySix()
+{
+    {
+        Vector<Counted> v(1000);
+        std::cout << "Alive after Vector(1000): " << Counted::s_alive << std::endl;
+        for (int i = 0; i < 10; i++)
+        {
+            v.EmplaceBack(i);
+        }
+        std::cout << "Alive after 10 insertions: " << Counted::s_alive << std::endl;
+
+        Vector<Counted> copy(v);
+        std::cout << "Alive after copy: " << Counted::s_alive << std::endl;
+    }
+    std::cout << "Alive after destruction: " << Counted::s_alive << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestTwentySeven()
+{
+    Vector<Counted> v;
+    for (int i = 0; i < 5; i++)
+    {
+        v.EmplaceBack(i);
+    }
+    int capacity = v.GetCapacity();
+
+    v.PopBack();
+    v.PopBack();
+    std::cout << "Size: " << v.GetSize() << ", last: " << v[v.GetSize() - 1].value << std::endl;
+    std::cout << "Alive after two PopBack() calls: " << Counted::s_alive << std::endl;
+    std::cout << "Capacity unchanged: " << (v.GetCapacity() == capacity ? "yes" : "no") << std::endl;
+
+    v.PushBack(Counted(9));
+    std::cout << "Last after PushBack(9): " << v[v.GetSize() - 1].value << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
+void TestTwentyEight()
+{
+    Vector<float> empty;
+    std::cout << "Empty data is null: " << (empty.GetData() == nullptr ? "yes" : "no") << std::endl;
+
+    Vector<float> v;
+    for (int i = 0; i < 100; i++)
+    {
+        v.PushBack(i * 0.5f);
+    }
+    const Vector<float> & constRef = v;
+    const float * data = constRef.GetData();
+    bool same = true;
+    for (int i = 0; i < v.GetSize(); i++)
+    {
+        same = same && (data[i] == v[i]);
+    }
+    std::cout << "GetData() matches operator[]: " << (same ? "yes" : "no") << std::endl;
+
+    v.GetData()[3] = 42.0f;
+    std::cout << "v[3] after write through GetData(): " << v[3] << std::endl;
+}
+
+//---------------------------------------------------------------------------------------
+
 void PassByValue(Vector<int> vec_copy)
 {
     vec_copy[0] = 2;
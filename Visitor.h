@@ -0,0 +1,69 @@
+#ifndef VISITOR_H
+#define VISITOR_H
+
+//---------------------------------------------------------------------------------------
+
+#include <type_traits>
+
+//---------------------------------------------------------------------------------------
+
+    /**
+    * @brief Calls a visitor that returns void, which never stops a traversal.
+    *
+    * @param visitor - The callable to call.
+    * @param value - The value to pass to it.
+    * @return false.
+    * @pre visitor accepts value.
+    * @post visitor has been called once with value.
+    */
+template <class Visitor, class T>
+bool CallVisitor(Visitor & visitor, const T & value, std::true_type)
+{
+    visitor(value);
+    return false;
+}
+
+//---------------------------------------------------------------------------------------
+
+    /**
+    * @brief Calls a visitor that returns a stop flag.
+    *
+    * @param visitor - The callable to call.
+    * @param value - The value to pass to it.
+    * @return The value returned by visitor, converted to bool.
+    * @pre visitor accepts value.
+    * @post visitor has been called once with value.
+    */
+template <class Visitor, class T>
+bool CallVisitor(Visitor & visitor, const T & value, std::false_type)
+{
+    return static_cast<bool>(visitor(value));
+}
+
+//---------------------------------------------------------------------------------------
+
+    /**
+    * @brief Calls the visitor of a templated traversal on one value and reports whether the traversal should stop.
+    *
+    * A visitor is any callable taking a const T &: a function, a function pointer, a functor or a lambda. The
+    * traversals of BST and EytzingerIndex take it as a template parameter, so its body can be inlined into the loop,
+    * and a lambda keeps its state in captured variables instead of globals or a context pointer. A visitor returning
+    * void visits every value; a visitor returning bool stops the traversal by returning true.
+    *
+    * @tparam Visitor The type of the callable.
+    * @tparam T The type of the values visited.
+    * @param visitor - The callable to call.
+    * @param value - The value to pass to it.
+    * @return true if visitor returned true, false if it returned false or void.
+    * @pre visitor accepts value.
+    * @post visitor has been called once with value.
+    */
+template <class Visitor, class T>
+bool CallVisitor(Visitor & visitor, const T & value)
+{
+    return CallVisitor(visitor, value, std::is_void<decltype(visitor(value))>());
+}
+
+//---------------------------------------------------------------------------------------
+
+#endif // VISITOR_H
@@ -1,25 +1,28 @@
 #include "atmospherelogtypes.h"
 #include "menu.h"
 #include "fileio.h"
-#include "BST.h"
+#include "EytzingerIndex.h"
 #include <map>
 
 //---------------------------------------------------------------------------------------
 
 int main()
 {
-    AtmosLogType atmos_data;
-    BST<AtmosRecType> atmos_bst;
-    std::map<int, AtmosLogType> atmos_map;
+    EytzingerIndex<AtmosRecType> atmos_index;
+    std::map<int, AtmosColumns> atmos_map;
 
-    if (!LoadAtmosphereData(atmos_data))
+    // The loaded records are only needed to fill the index and the map, so they are freed before the menu runs
     {
-        return -1;
-    }
+        AtmosLogType atmos_data;
+        if (!LoadAtmosphereData(atmos_data))
+        {
+            return -1;
+        }
 
-    TransferToBSTAndMap(atmos_data, atmos_bst, atmos_map);
+        TransferToIndexAndMap(atmos_data, atmos_index, atmos_map);
+    }
 
-    RunMenuLoop(atmos_bst, atmos_map);
+    RunMenuLoop(atmos_index, atmos_map);
 
     return 0;
 }